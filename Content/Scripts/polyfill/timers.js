@@ -1,8 +1,6 @@
 (function (target) {
-    var makeWindowTimer = require('./windowTimers')
+    // setTimeout, setInterval, setImmediate and their clear functions are provided natively by the context
     if (Root == undefined || Root.OnTick == undefined) return
-    
-    var timerLoop = makeWindowTimer(target);
 
     var current_time = 0
     target.$time = 0
@@ -21,9 +19,6 @@
         
         current_time += elapsedTime
         target.$time = current_time
-
-        // non blocking
-        timerLoop(true);
     }
 
     target.process = {
@@ -43,4 +38,4 @@
     }
 
     Root.OnTick.Add(root)
-})(this)
\ No newline at end of file
+})(this)
@@ -0,0 +1,224 @@
+#include "BoundaryProfiler.h"
+#include "Translator.h"
+#include "Helpers.h"
+#include "JavascriptRuntimeMemory.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+bool FJavascriptBoundaryProfiler::bEnabled = false;
+
+namespace
+{
+	const int32 DefaultDumpRows = 50;
+
+	struct FBoundaryEntry
+	{
+		EJavascriptBoundary Kind;
+		FString Name;
+		uint64 Calls = 0;
+		uint64 InclusiveCycles = 0;
+		uint64 InnerCycles = 0;
+
+		uint64 GetMarshalCycles() const { return InclusiveCycles - FMath::Min(InnerCycles, InclusiveCycles); }
+	};
+
+	// Script functions are garbage collected and their references reused, so entries of callbacks are keyed
+	// on the signature they implement and where they are defined rather than on the function itself
+	struct FBoundaryKey
+	{
+		uint8 Kind;
+		const void* Member;
+		FString Location;
+
+		bool operator == (const FBoundaryKey& Other) const
+		{
+			return Kind == Other.Kind && Member == Other.Member && Location == Other.Location;
+		}
+
+		friend uint32 GetTypeHash(const FBoundaryKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Kind), GetTypeHash(Key.Member)), GetTypeHash(Key.Location));
+		}
+	};
+
+	TMap<FBoundaryKey, TUniquePtr<FBoundaryEntry>> Entries;
+
+	// Entries of script functions by function and signature, so that a function's location is only resolved
+	// the first time it is seen. Function references are reused once collected, so this is emptied on every collection.
+	TMap<TPair<const void*, const UObject*>, FBoundaryEntry*> ScriptFunctionEntries;
+	uint32 ScriptFunctionEntriesSerial = 0;
+
+	const TCHAR* KindNames[] = { TEXT("ue"), TEXT("js"), TEXT("proxy"), TEXT("get"), TEXT("set") };
+	static_assert(ARRAY_COUNT(KindNames) == (int32)EJavascriptBoundary::Num, "Boundary kind without a name");
+
+	FString GetMemberName(const UObject* Member)
+	{
+		const UObject* Outer = Member->GetOuter();
+		return Outer ? Outer->GetName() + TEXT(".") + Member->GetName() : Member->GetName();
+	}
+
+	// file:line:column of a script function, empty for native and bound functions
+	FString GetScriptLocation(JsValueRef Function)
+	{
+		JsValueRef Position = JS_INVALID_REFERENCE;
+		if (JsDiagGetFunctionPosition(Function, &Position) != JsNoError)
+		{
+			return FString();
+		}
+
+		return FString::Printf(TEXT("%s:%d:%d"),
+			*FPaths::GetCleanFilename(chakra::StringFromChakra(chakra::GetProperty(Position, "fileName"))),
+			chakra::IntFrom(chakra::GetProperty(Position, "line")) + 1,
+			chakra::IntFrom(chakra::GetProperty(Position, "column")) + 1);
+	}
+
+	// names are resolved once, when a key is first seen
+	FString GetName(EJavascriptBoundary Kind, const void* Key, const UObject* Signature, const FString& Location)
+	{
+		if (Kind != EJavascriptBoundary::CallToScript)
+		{
+			return Key ? GetMemberName(reinterpret_cast<const UObject*>(Key)) : FString(TEXT("<none>"));
+		}
+
+		FString Name = chakra::StringFromChakra(chakra::GetProperty((JsValueRef)Key, "name"));
+		if (Name.IsEmpty())
+		{
+			Name = TEXT("<anonymous>");
+		}
+		if (!Location.IsEmpty())
+		{
+			Name += FString::Printf(TEXT(" @%s"), *Location);
+		}
+		return Signature ? FString::Printf(TEXT("%s (%s)"), *Name, *GetMemberName(Signature)) : Name;
+	}
+
+	void HandleCommand(const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		const FString Command = Args.Num() ? Args[0] : FString(TEXT("dump"));
+		if (Command == TEXT("start"))
+		{
+			FJavascriptBoundaryProfiler::Start();
+			Ar.Log(TEXT("Boundary profiler started"));
+		}
+		else if (Command == TEXT("stop"))
+		{
+			FJavascriptBoundaryProfiler::Stop();
+			Ar.Log(TEXT("Boundary profiler stopped"));
+		}
+		else if (Command == TEXT("reset"))
+		{
+			FJavascriptBoundaryProfiler::Reset();
+		}
+		else
+		{
+			FJavascriptBoundaryProfiler::Dump(Ar, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : DefaultDumpRows);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice BoundaryProfilerCommand(
+	TEXT("javascript.BoundaryProfiler"),
+	TEXT("Profiles calls between script and engine. start | stop | reset | dump [rows]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&HandleCommand));
+
+void FJavascriptBoundaryProfiler::Start()
+{
+	bEnabled = true;
+}
+
+void FJavascriptBoundaryProfiler::Stop()
+{
+	bEnabled = false;
+}
+
+void FJavascriptBoundaryProfiler::Reset()
+{
+	ScriptFunctionEntries.Empty();
+	Entries.Empty();
+}
+
+void FJavascriptBoundaryProfiler::Record(EJavascriptBoundary Kind, const void* Key, const UObject* Signature, uint64 InclusiveCycles, uint64 InnerCycles)
+{
+	// contexts running off the game thread are not profiled
+	if (!IsInGameThread())
+	{
+		return;
+	}
+
+	FBoundaryEntry* Entry = nullptr;
+	const TPair<const void*, const UObject*> FunctionKey(Key, Signature);
+	if (Kind == EJavascriptBoundary::CallToScript)
+	{
+		const uint32 Serial = FJavascriptRuntimeMemory::GetCollectionSerial();
+		if (Serial != ScriptFunctionEntriesSerial)
+		{
+			ScriptFunctionEntries.Reset();
+			ScriptFunctionEntriesSerial = Serial;
+		}
+
+		if (FBoundaryEntry** Cached = ScriptFunctionEntries.Find(FunctionKey))
+		{
+			Entry = *Cached;
+		}
+	}
+
+	if (!Entry)
+	{
+		FBoundaryKey EntryKey{ (uint8)Kind, Key };
+		if (Kind == EJavascriptBoundary::CallToScript)
+		{
+			EntryKey.Member = Signature;
+			EntryKey.Location = GetScriptLocation((JsValueRef)Key);
+		}
+
+		TUniquePtr<FBoundaryEntry>& Found = Entries.FindOrAdd(EntryKey);
+		if (!Found.IsValid())
+		{
+			Found = MakeUnique<FBoundaryEntry>();
+			Found->Kind = Kind;
+			Found->Name = GetName(Kind, Key, Signature, EntryKey.Location);
+		}
+		Entry = Found.Get();
+
+		// added after resolving, which reads script properties and may record nested crossings
+		if (Kind == EJavascriptBoundary::CallToScript)
+		{
+			ScriptFunctionEntries.Add(FunctionKey, Entry);
+		}
+	}
+
+	Entry->Calls++;
+	Entry->InclusiveCycles += InclusiveCycles;
+	Entry->InnerCycles += InnerCycles;
+}
+
+void FJavascriptBoundaryProfiler::Dump(FOutputDevice& Ar, int32 MaxRows)
+{
+	TArray<const FBoundaryEntry*> Sorted;
+	for (const auto& Pair : Entries)
+	{
+		Sorted.Add(Pair.Value.Get());
+	}
+	Sorted.Sort([](const FBoundaryEntry& A, const FBoundaryEntry& B) { return A.InclusiveCycles > B.InclusiveCycles; });
+
+	Ar.Logf(TEXT("%-6s %-64s %10s %12s %12s %8s %10s"), TEXT("Kind"), TEXT("Name"), TEXT("Calls"), TEXT("Incl (ms)"), TEXT("Marshal (ms)"), TEXT("Marshal%"), TEXT("Avg (us)"));
+	for (int32 Index = 0; Index < FMath::Min(Sorted.Num(), MaxRows); ++Index)
+	{
+		const FBoundaryEntry& Entry = *Sorted[Index];
+		const double Inclusive = FPlatformTime::ToMilliseconds64(Entry.InclusiveCycles);
+		const double Marshal = FPlatformTime::ToMilliseconds64(Entry.GetMarshalCycles());
+		Ar.Logf(TEXT("%-6s %-64s %10llu %12.3f %12.3f %7.1f%% %10.2f"),
+			KindNames[(int32)Entry.Kind], *Entry.Name, Entry.Calls, Inclusive, Marshal,
+			Inclusive > 0 ? Marshal * 100.0 / Inclusive : 0.0,
+			Entry.Calls ? Inclusive * 1000.0 / Entry.Calls : 0.0);
+	}
+
+	if (Sorted.Num() > MaxRows)
+	{
+		Ar.Logf(TEXT("... %d more"), Sorted.Num() - MaxRows);
+	}
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "V8PCH.h"
+
+enum class EJavascriptBoundary : uint8
+{
+	CallToEngine,	// script calling a UFunction
+	CallToScript,	// native calling a script function
+	ProxyCall,		// UFunction implemented by script
+	PropertyGet,
+	PropertySet,
+	Num
+};
+
+// Aggregates calls, inclusive time and marshalling time of crossings between script and engine,
+// per UFunction, per property and per script callback. Off unless started (javascript.BoundaryProfiler),
+// a crossing costs a flag check then.
+class FJavascriptBoundaryProfiler
+{
+public:
+	static bool IsEnabled() { return bEnabled; }
+
+	static void Start();
+	static void Stop();
+	static void Reset();
+	static void Dump(FOutputDevice& Ar, int32 MaxRows);
+
+	// Key is the UFunction or UProperty crossed, or the script function for CallToScript (Signature then names the UFunction it implements).
+	// Script functions are only looked at while recording, their calls are aggregated per signature and script location.
+	static void Record(EJavascriptBoundary Kind, const void* Key, const UObject* Signature, uint64 InclusiveCycles, uint64 InnerCycles);
+
+private:
+	static bool bEnabled;
+};
+
+// Times one crossing. Whatever runs on the other side goes between BeginInner and EndInner,
+// the rest of the inclusive time is accounted as marshalling.
+class FJavascriptBoundaryScope
+{
+public:
+	FJavascriptBoundaryScope(EJavascriptBoundary InKind, const void* InKey, const UObject* InSignature = nullptr)
+		: Kind(InKind)
+		, Key(InKey)
+		, Signature(InSignature)
+		, StartCycles(FJavascriptBoundaryProfiler::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FJavascriptBoundaryScope()
+	{
+		if (StartCycles)
+		{
+			FJavascriptBoundaryProfiler::Record(Kind, Key, Signature, FPlatformTime::Cycles64() - StartCycles, InnerCycles);
+		}
+	}
+
+	void BeginInner()
+	{
+		if (StartCycles)
+		{
+			InnerStartCycles = FPlatformTime::Cycles64();
+		}
+	}
+
+	void EndInner()
+	{
+		if (StartCycles)
+		{
+			InnerCycles += FPlatformTime::Cycles64() - InnerStartCycles;
+		}
+	}
+
+private:
+	EJavascriptBoundary Kind;
+	const void* Key;
+	const UObject* Signature;
+	uint64 StartCycles;
+	uint64 InnerStartCycles = 0;
+	uint64 InnerCycles = 0;
+};
@@ -46,6 +46,51 @@ struct FV8Config
 		}
 	}
 
+	// Inverse of Safeify; returns empty string for names which Safeify never produces
+	static FString Unsafeify(const FString& Name)
+	{
+		if (Name == "UObject")
+		{
+			return TEXT("Object");
+		}
+		else if (Name == "UNode")
+		{
+			return TEXT("Node");
+		}
+		else if (Name == "UFunction")
+		{
+			return TEXT("Function");
+		}
+		else if (Name == "UPointerEvent")
+		{
+			return TEXT("PointerEvent");
+		}
+		else if (Name == "UImage")
+		{
+			return TEXT("Image");
+		}
+		else if (Name == "USelection")
+		{
+			return TEXT("Selection");
+		}
+		else if (Name == "UFocusEvent")
+		{
+			return TEXT("FocusEvent");
+		}
+		else if (Name == "FText")
+		{
+			return TEXT("Text");
+		}
+		else if (Safeify(Name) != Name)
+		{
+			return FString();
+		}
+		else
+		{
+			return Name;
+		}
+	}
+
 	// 
 	static bool CanExportClass(const UClass* Class)
 	{
@@ -5,6 +5,7 @@
 #include "Translator.h"
 #include "Helpers.h"
 #include "JavascriptStats.h"
+#include "JavascriptTrace.h"
 #include "UObject/GCObject.h"
 #include "V8PCH.h"
 
@@ -16,19 +17,47 @@ public:
 	FWeakObjectPtr WeakObject;
 	UProperty* Property;
 	Persistent<JsContextRef> context_;
-	TMap<int32, Persistent<JsValueRef>> functions;
 	Persistent<JsValueRef> WrappedObject;
-	int32 NextUniqueId{ 0 };
 	bool bAbandoned{ false };
 
+	// Single engine binding for this property, fanned out to every subscribed function
+	UJavascriptDelegate* DelegateObject{ nullptr };
+
+	struct FSubscription
+	{
+		FSubscription(JsValueRef InFunction, uint32 InSerial, int32 InPrev)
+			: Function(InFunction), Serial(InSerial), Prev(InPrev)
+		{}
+
+		Persistent<JsValueRef> Function;
+		uint32 Serial;
+		int32 Prev;
+		int32 Next{ INDEX_NONE };
+	};
+
+	// Linked in subscription order, so that removal doesn't shift anything
+	TSparseArray<FSubscription> Subscriptions;
+	TMultiMap<JsValueRef, int32> SubscriptionsByFunction;
+	int32 Head{ INDEX_NONE };
+	int32 Tail{ INDEX_NONE };
+	uint32 NextSerial{ 0 };
+
 	bool IsValid() const
 	{
 		return WeakObject.IsValid();
 	}
 
+	bool IsMulticast() const
+	{
+		return Property->IsA<UMulticastDelegateProperty>();
+	}
+
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
 	{
-		Collector.AddReferencedObjects(DelegateObjects);
+		if (DelegateObject)
+		{
+			Collector.AddReferencedObject(DelegateObject);
+		}
 	}
 
 	FJavascriptDelegate(UObject* InObject, UProperty* InProperty)
@@ -48,7 +77,13 @@ public:
 
 			WrappedObject.Reset();
 
-			ClearDelegateObjects();
+			Clear();
+
+			if (DelegateObject)
+			{
+				DelegateObject->JavascriptDelegate.Reset();
+				DelegateObject = nullptr;
+			}
 
 			context_.Reset();
 		}
@@ -112,37 +147,22 @@ public:
 		auto toJSON = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
 			auto payload = reinterpret_cast<FJavascriptDelegate*>(callbackState);
 
-			uint32_t Index = 0;
-			JsValueRef arr = JS_INVALID_REFERENCE;
-			JsCheck(JsCreateArray(payload->DelegateObjects.Num(), &arr));
-			const bool bIsMulticastDelegate = payload->Property->IsA(UMulticastDelegateProperty::StaticClass());
-
-			for (auto DelegateObject : payload->DelegateObjects)
+			if (!payload->IsMulticast())
 			{
-				auto JavascriptFunction = payload->functions.Find(DelegateObject->UniqueId);
-				if (JavascriptFunction)
-				{
-					JsValueRef function = JavascriptFunction->Get();
-					if (!bIsMulticastDelegate)
-					{
-						return function;
-					}
-
-					chakra::SetIndex(arr, Index++, function);
-				}
+				return payload->Head != INDEX_NONE ? payload->Subscriptions[payload->Head].Function.Get() : chakra::Null();
 			}
 
-			if (!bIsMulticastDelegate)
-			{
-				return chakra::Null();
-			}
-			else
+			JsValueRef arr = JS_INVALID_REFERENCE;
+			JsCheck(JsCreateArray(payload->Subscriptions.Num(), &arr));
+
+			int32 Index = 0;
+			for (int32 It = payload->Head; It != INDEX_NONE; It = payload->Subscriptions[It].Next)
 			{
-				return arr;
+				chakra::SetIndex(arr, Index++, payload->Subscriptions[It].Function.Get());
 			}
-		};
 
-		JsValueRef data = chakra::External(this, nullptr);
+			return arr;
+		};
 
 		chakra::SetProperty(out, "Add", chakra::FunctionTemplate(add, this));
 		chakra::SetProperty(out, "Remove", chakra::FunctionTemplate(remove, this));
@@ -154,54 +174,41 @@ public:
 		return out;
 	}
 
-	TArray<UJavascriptDelegate*> DelegateObjects;
-
-	void ClearDelegateObjects()
+	void Add(JsValueRef function)
 	{
-		for (auto obj : DelegateObjects)
+		// a single-cast delegate holds one function at a time
+		if (!IsMulticast())
 		{
-			obj->RemoveFromRoot();
+			Clear();
 		}
-		DelegateObjects.Empty();
-		functions.Empty();
-	}
 
-	void Add(JsValueRef function)
-	{
-		auto DelegateObject = NewObject<UJavascriptDelegate>();
+		FSparseArrayAllocationInfo Allocation = Subscriptions.AddUninitialized();
+		new (Allocation) FSubscription(function, NextSerial++, Tail);
 
-		DelegateObject->UniqueId = NextUniqueId++;
+		if (Tail != INDEX_NONE)
+		{
+			Subscriptions[Tail].Next = Allocation.Index;
+		}
+		else
+		{
+			Head = Allocation.Index;
+		}
+		Tail = Allocation.Index;
 
-		Bind(DelegateObject, function);
-	}
+		SubscriptionsByFunction.Add(function, Allocation.Index);
 
-	UJavascriptDelegate* FindJavascriptDelegateByFunction(JsValueRef function)
-	{
-		bool bWasSuccessful = false;
-		for (auto it = functions.CreateIterator(); it; ++it)
+		if (Head == Tail)
 		{
-			if (it.Value().Get() == function)
-			{
-				for (auto obj : DelegateObjects)
-				{
-					if (obj->UniqueId == it.Key())
-					{
-						return obj;
-					}
-				}
-			}
+			Bind();
 		}
-
-		return nullptr;
 	}
 
 	void Remove(JsValueRef function)
 	{
-		auto obj = FindJavascriptDelegateByFunction(function);
-
-		if (obj)
+		const int32* Found = SubscriptionsByFunction.Find(function);
+		if (Found)
 		{
-			Unbind(obj);
+			RemoveAt(*Found);
 		}
 		else
 		{
@@ -211,16 +218,53 @@ public:
 
 	void Clear()
 	{
-		while (DelegateObjects.Num())
+		while (Head != INDEX_NONE)
+		{
+			RemoveAt(Head);
+		}
+	}
+
+	void RemoveAt(int32 Index)
+	{
+		FSubscription& Subscription = Subscriptions[Index];
+
+		if (Subscription.Prev != INDEX_NONE)
+		{
+			Subscriptions[Subscription.Prev].Next = Subscription.Next;
+		}
+		else
+		{
+			Head = Subscription.Next;
+		}
+
+		if (Subscription.Next != INDEX_NONE)
 		{
-			Unbind(DelegateObjects[0]);
+			Subscriptions[Subscription.Next].Prev = Subscription.Prev;
+		}
+		else
+		{
+			Tail = Subscription.Prev;
+		}
+
+		SubscriptionsByFunction.RemoveSingle(Subscription.Function.Get(), Index);
+		Subscriptions.RemoveAt(Index);
+
+		if (Head == INDEX_NONE)
+		{
+			Unbind();
 		}
 	}
 
-	void Bind(UJavascriptDelegate* DelegateObject, JsValueRef function)
+	void Bind()
 	{
 		static FName NAME_Fire("Fire");
 
+		if (!DelegateObject)
+		{
+			DelegateObject = NewObject<UJavascriptDelegate>();
+			DelegateObject->JavascriptDelegate = AsShared();
+		}
+
 		if (WeakObject.IsValid())
 		{
 			if (auto p = Cast<UMulticastDelegateProperty>(Property))
@@ -229,7 +273,7 @@ public:
 				Delegate.BindUFunction(DelegateObject, NAME_Fire);
 
 				auto Target = p->GetPropertyValuePtr_InContainer(WeakObject.Get());
-				Target->Add(Delegate);
+				Target->AddUnique(Delegate);
 			}
 			else if (auto p = Cast<UDelegateProperty>(Property))
 			{
@@ -237,18 +281,13 @@ public:
 				Target->BindUFunction(DelegateObject, NAME_Fire);
 			}
 		}
-
-		DelegateObject->JavascriptDelegate = AsShared();
-		DelegateObjects.Add(DelegateObject);
-
-		functions.Add( DelegateObject->UniqueId, function );
 	}
 
-	void Unbind(UJavascriptDelegate* DelegateObject)
+	void Unbind()
 	{
 		static FName NAME_Fire("Fire");
 
-		if (WeakObject.IsValid())
+		if (DelegateObject && WeakObject.IsValid())
 		{
 			if (auto p = Cast<UMulticastDelegateProperty>(Property))
 			{
@@ -261,17 +300,12 @@ public:
 			else if (auto p = Cast<UDelegateProperty>(Property))
 			{
 				auto Target = p->GetPropertyValuePtr_InContainer(WeakObject.Get());
-				Target->Clear();
+				if (Target->GetUObject() == DelegateObject)
+				{
+					Target->Clear();
+				}
 			}
 		}
-
-		DelegateObject->JavascriptDelegate.Reset();
-		DelegateObjects.Remove(DelegateObject);
-
-		if (!bAbandoned)
-		{
-			functions.Remove(DelegateObject->UniqueId);
-		}
 	}
 
 	UFunction* GetSignatureFunction()
@@ -290,29 +324,42 @@ public:
 		}
 	}
 
-	void Fire(void* Parms, UJavascriptDelegate* Delegate)
+	void Fire(void* Parms)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_JavascriptDelegate);
+		FJavascriptTraceScope TraceScope(TEXT("DelegateFire"), Property);
 
-		if (!Delegate->IsValidLowLevelFast())
+		if (!WeakObject.IsValid() || Head == INDEX_NONE)
 		{
 			return;
 		}
 
-		auto Buffer = reinterpret_cast<uint8*>(Parms);		
+		// handlers may subscribe or unsubscribe while firing, only call the ones still there
+		TArray<TPair<int32, uint32>, TInlineAllocator<8>> Snapshot;
+		for (int32 It = Head; It != INDEX_NONE; It = Subscriptions[It].Next)
+		{
+			Snapshot.Emplace(It, Subscriptions[It].Serial);
+		}
+
+		FContextScope Scope(context_.Get());
+		JsValueRef Global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&Global));
 
-		auto it = functions.Find(Delegate->UniqueId);
-		if (WeakObject.IsValid() && it)
+		UFunction* SignatureFunction = GetSignatureFunction();
+		for (const auto& Entry : Snapshot)
 		{
-			JsValueRef func = it->Get();
-			if (!chakra::IsEmpty(func))
+			if (bAbandoned || !WeakObject.IsValid())
 			{
-				FContextScope Scope(context_.Get());
-				JsValueRef Global = JS_INVALID_REFERENCE;
-				JsCheck(JsGetGlobalObject(&Global));
+				break;
+			}
 
-				chakra::CallJavascriptFunction(context_.Get(), Global, GetSignatureFunction(), func, Parms);
+			if (!Subscriptions.IsValidIndex(Entry.Key) || Subscriptions[Entry.Key].Serial != Entry.Value)
+			{
+				continue;
 			}
+
+			JsValueRef func = Subscriptions[Entry.Key].Function.Get();
+			chakra::CallJavascriptFunction(context_.Get(), Global, SignatureFunction, func, Parms);
 		}
 	}
 };
@@ -332,54 +379,87 @@ struct FDelegateManager : chakra::IDelegateManager
 		delete this;
 	}
 
-	TSet<TSharedPtr<FJavascriptDelegate>> Delegates;
+	// One delegate per bound object and property, a re-created wrapper finds its subscriptions again
+	TMap<TPair<UObject*, UProperty*>, TSharedPtr<FJavascriptDelegate>> Delegates;
+
+	// Dead delegates are swept once the table doubled since the last sweep
+	int32 SweepThreshold{ 64 };
 
 	void CollectGarbageDelegates()
 	{
 		for (auto it = Delegates.CreateIterator(); it; ++it)
 		{
-			auto d = *it;
-			if (!d->IsValid())
+			if (!it.Value()->IsValid())
 			{
 				it.RemoveCurrent();
-				d.Reset();
 			}
 		}
+
+		SweepThreshold = FMath::Max(64, Delegates.Num() * 2);
 	}
 
 	void PurgeAllDelegates()
 	{
-		for (auto& d : Delegates)
+		for (auto& Pair : Delegates)
 		{
-			d.Reset();
+			Pair.Value.Reset();
 		}
 		Delegates.Empty();
 	}
 
 	JsValueRef CreateDelegate(UObject* Object, UProperty* Property)
 	{
-		//@HACK
-		CollectGarbageDelegates();
+		const TPair<UObject*, UProperty*> Key(Object, Property);
+
+		// the address may belong to another object by now
+		TSharedPtr<FJavascriptDelegate>* Found = Delegates.Find(Key);
+		if (Found && (*Found)->WeakObject.Get() == Object && !(*Found)->WrappedObject.IsEmpty())
+		{
+			return (*Found)->WrappedObject.Get();
+		}
+
+		if (Delegates.Num() >= SweepThreshold)
+		{
+			CollectGarbageDelegates();
+		}
 
 		TSharedPtr<FJavascriptDelegate> payload = MakeShareable(new FJavascriptDelegate(Object, Property));
 		JsContextRef context = JS_INVALID_REFERENCE;
 		JsCheck(JsGetCurrentContext(&context));
 		JsValueRef created = payload->Initialize(context);
 
-		Delegates.Add(payload);
+		Delegates.Add(Key, payload);
 
 		return created;
 	}
 
+	// "$internal_<name>" ids per delegate property, so the key isn't formatted on every access
+	TMap<UProperty*, TPair<FName, JsPropertyIdRef>> CacheIds;
+
+	JsPropertyIdRef GetCacheId(UProperty* Property)
+	{
+		auto Found = CacheIds.Find(Property);
+		if (Found && Found->Key == Property->GetFName())
+		{
+			return Found->Value;
+		}
+
+		JsPropertyIdRef cache_id = chakra::PropertyID(FString::Printf(TEXT("$internal_%s"), *(Property->GetName())));
+		JsCheck(JsAddRef(cache_id, nullptr));
+		CacheIds.Add(Property, TPair<FName, JsPropertyIdRef>(Property->GetFName(), cache_id));
+		return cache_id;
+	}
+
 	virtual JsValueRef GetProxy(JsValueRef This, UObject* Object, UProperty* Property) override
 	{
-		FString cache_id = FString::Printf(TEXT("$internal_%s"), *(Property->GetName()));
-		JsValueRef cached = chakra::GetProperty(This, cache_id);
+		JsPropertyIdRef cache_id = GetCacheId(Property);
+		JsValueRef cached = JS_INVALID_REFERENCE;
+		JsCheck(JsGetProperty(This, cache_id, &cached));
 		if (chakra::IsEmpty(cached) || chakra::IsUndefined(cached))
 		{
 			JsValueRef created = CreateDelegate(Object, Property);
 
-			chakra::SetProperty(This, cache_id, created);
+			JsCheck(JsSetProperty(This, cache_id, created, true));
 			return created;
 		}
 		else
@@ -426,7 +506,7 @@ void UJavascriptDelegate::ProcessEvent(UFunction* Function, void* Parms)
 {
 	if (!Paused && JavascriptDelegate.IsValid())
 	{
-		JavascriptDelegate.Pin()->Fire(Parms, this);
+		JavascriptDelegate.Pin()->Fire(Parms);
 	}
 }
 
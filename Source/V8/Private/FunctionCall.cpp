@@ -7,42 +7,101 @@ PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
 #include "Exception.h"
 #include "Helpers.h"
 #include "JavascriptStats.h"
+#include "BoundaryProfiler.h"
 
-namespace chakra
+namespace
 {
-	void CallJavascriptFunction(JsContextRef context, JsValueRef This, UFunction* SignatureFunction, JsValueRef func, void* Parms)
+	// Parameter layout of a signature called from native code, built on its first call
+	struct FSignaturePlan
 	{
-		SCOPE_CYCLE_COUNTER(STAT_JavascriptFunctionCallToJavascript);
+		// a recompiled blueprint may reuse the address of a collected function
+		FWeakObjectPtr Function;
 
-		auto Buffer = reinterpret_cast<uint8*>(Parms);		
+		TArray<UProperty*> InParams;
+		// 'T&' parameters written back from the returned object, 'const T&' is rejected
+		TArray<UProperty*> OutParams;
+		UProperty* ReturnParam = nullptr;
+	};
 
-		enum { MaxArgs = 32 };
+	// only ever used on the game thread
+	TMap<UFunction*, TSharedPtr<FSignaturePlan>> SignaturePlans;
 
-		JsValueRef argv[MaxArgs] = { This };
-		int argc = 1;
+	// Callers keep the reference across the call, script may trigger a recompile which replaces the plan
+	TSharedRef<const FSignaturePlan> GetSignaturePlan(UFunction* SignatureFunction)
+	{
+		static const TSharedRef<const FSignaturePlan> EmptyPlan = MakeShared<FSignaturePlan>();
+		if (SignatureFunction == nullptr)
+		{
+			return EmptyPlan;
+		}
 
-		auto jsContext = FJavascriptContext::FromChakra(context);
+		// pending kill functions are still called (eg. while a blueprint is being reinstanced), don't rebuild for them
+		TSharedPtr<FSignaturePlan>& Plan = SignaturePlans.FindOrAdd(SignatureFunction);
+		if (Plan.IsValid() && Plan->Function.Get(true) == SignatureFunction)
+		{
+			return Plan.ToSharedRef();
+		}
+
+		Plan = MakeShared<FSignaturePlan>();
+		Plan->Function = SignatureFunction;
 
 		TFieldIterator<UProperty> Iter(SignatureFunction);
-		for (; Iter && argc < MaxArgs && (Iter->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm; ++Iter)
+		for (; Iter && (Iter->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm; ++Iter)
 		{
-			UProperty* Param = *Iter;
-			argv[argc++] = jsContext->ReadProperty(Param, Buffer, FNoPropertyOwner());
+			Plan->InParams.Add(*Iter);
 		}
 
-		UProperty* ReturnParam = nullptr;
 		for (; Iter; ++Iter)
 		{
-			UProperty* Param = *Iter;
-			if (Param->GetPropertyFlags() & CPF_ReturnParm)
+			if (Iter->GetPropertyFlags() & CPF_ReturnParm)
 			{
-				ReturnParam = Param;
+				Plan->ReturnParam = *Iter;
 				break;
 			}
 		}
 
+		if (SignatureFunction->HasAnyFunctionFlags(FUNC_HasOutParms))
+		{
+			for (UProperty* Param : Plan->InParams)
+			{
+				if ((Param->PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
+				{
+					Plan->OutParams.Add(Param);
+				}
+			}
+		}
+
+		return Plan.ToSharedRef();
+	}
+}
+
+namespace chakra
+{
+	void CallJavascriptFunction(JsContextRef context, JsValueRef This, UFunction* SignatureFunction, JsValueRef func, void* Parms)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_JavascriptFunctionCallToJavascript);
+		FJavascriptBoundaryScope BoundaryScope(EJavascriptBoundary::CallToScript, func, SignatureFunction);
+
+		auto Buffer = reinterpret_cast<uint8*>(Parms);
+
+		const TSharedRef<const FSignaturePlan> PlanRef = GetSignaturePlan(SignatureFunction);
+		const FSignaturePlan& Plan = *PlanRef;
+		check(Plan.InParams.Num() < MAX_uint16);
+
+		auto jsContext = FJavascriptContext::FromChakra(context);
+
+		TArray<JsValueRef, TInlineAllocator<16>> argv;
+		argv.Reserve(Plan.InParams.Num() + 1);
+		argv.Add(This);
+		for (UProperty* Param : Plan.InParams)
+		{
+			argv.Add(jsContext->ReadProperty(Param, Buffer, FNoPropertyOwner()));
+		}
+
 		JsValueRef value = JS_INVALID_REFERENCE;
-		JsErrorCode invokeErr = JsCallFunction(func, argv, argc, &value);
+		BoundaryScope.BeginInner();
+		JsErrorCode invokeErr = JsCallFunction(func, argv.GetData(), (unsigned short)argv.Num(), &value);
+		BoundaryScope.EndInner();
 		if (invokeErr == JsErrorScriptException)
 		{
 			JsValueRef exception = JS_INVALID_REFERENCE;
@@ -51,22 +110,7 @@ namespace chakra
 			jsContext->UncaughtException(FV8Exception::Report(exception));
 		}
 
-		bool bHasAnyOutParams = false;
-		if (SignatureFunction && SignatureFunction->HasAnyFunctionFlags(FUNC_HasOutParms))
-		{
-			// Iterate over input parameters
-			for (TFieldIterator<UProperty> It(SignatureFunction); It && (It->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm; ++It)
-			{
-				// This is 'out ref'!
-				if ((It->PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
-				{
-					bHasAnyOutParams = true;
-					break;
-				}
-			}
-		}
-
-		if (bHasAnyOutParams)
+		if (Plan.OutParams.Num())
 		{
 			if (chakra::IsEmpty(value) || !chakra::IsObject(value))
 			{
@@ -76,40 +120,33 @@ namespace chakra
 
 			JsValueRef Object = value;
 
-			// Iterate over parameters again
-			for (TFieldIterator<UProperty> It(SignatureFunction); It; ++It)
+			// 'T&' comes back under its name
+			for (UProperty* Param : Plan.OutParams)
 			{
-				UProperty* Param = *It;
+				JsValueRef sub_value = chakra::GetProperty(Object, Param);
 
-				auto PropertyFlags = Param->GetPropertyFlags();					
-
-				// pass return parameter as '$'
-				if (PropertyFlags & CPF_ReturnParm)
+				if (!chakra::IsEmpty(sub_value))
 				{
-					JsValueRef sub_value = chakra::GetProperty(Object, "$");
-
-					jsContext->WriteProperty(ReturnParam, Buffer, sub_value);						
+					// value can be null if isolate is in trouble
+					jsContext->WriteProperty(Param, Buffer, sub_value);
 				}
-				// rejects 'const T&' and pass 'T&' as its name
-				else if ((PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
-				{
-					JsValueRef sub_value = chakra::GetProperty(Object, Param->GetName());
+			}
 
-					if (!chakra::IsEmpty(sub_value))
-					{
-						// value can be null if isolate is in trouble
-						jsContext->WriteProperty(Param, Buffer, sub_value);
-					}						
-				}
-			}			
+			// pass return parameter as '$'
+			if (Plan.ReturnParam)
+			{
+				JsValueRef sub_value = chakra::GetProperty(Object, "$");
+
+				jsContext->WriteProperty(Plan.ReturnParam, Buffer, sub_value);
+			}
 		}
 		else
 		{
-			if (ReturnParam)
+			if (Plan.ReturnParam)
 			{
-				jsContext->WriteProperty(ReturnParam, Buffer, value);
+				jsContext->WriteProperty(Plan.ReturnParam, Buffer, value);
 			}
-		}		
+		}
 	}
 }
 
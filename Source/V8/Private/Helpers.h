@@ -68,6 +68,31 @@ namespace chakra
 		return stringValue;
 	}
 
+	// doubles hold integers exactly up to 2^53, larger 64-bit values travel as decimal strings
+	static const int64 MaxSafeInteger = (1LL << 53);
+
+	static JsValueRef Int64(int64 Value)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::Int64"));
+		if (Value >= -MaxSafeInteger && Value <= MaxSafeInteger)
+		{
+			return Double((double)Value);
+		}
+
+		return String(FString::Printf(TEXT("%lld"), Value));
+	}
+
+	static JsValueRef UInt64(uint64 Value)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::UInt64"));
+		if (Value <= (uint64)MaxSafeInteger)
+		{
+			return Double((double)Value);
+		}
+
+		return String(FString::Printf(TEXT("%llu"), Value));
+	}
+
 	static void Throw(const FString& InString)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::Throw"));
@@ -168,6 +193,18 @@ namespace chakra
 		return Type == JsArray;
 	}
 
+	static bool IsTypedArray(JsValueRef Value)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::IsTypedArray %p"), Value);
+		if (Value == JS_INVALID_REFERENCE)
+			return false;
+
+		JsValueType Type = JsUndefined;
+		JsCheck(JsGetValueType(Value, &Type));
+
+		return Type == JsTypedArray;
+	}
+
 	static bool IsNumber(JsValueRef Value)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::IsNumber %p"), Value);
@@ -262,6 +299,43 @@ namespace chakra
 		return dValue;
 	}
 
+	static int64 Int64From(JsValueRef Value)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::Int64From %p"), Value);
+		JsValueType Type = JsUndefined;
+		JsGetValueType(Value, &Type);
+		if (Type == JsString)
+		{
+			return FCString::Atoi64(*StringFromChakra(Value));
+		}
+
+		const double dValue = DoubleFrom(Value);
+		if (!FMath::IsFinite(dValue))
+		{
+			return 0;
+		}
+		// (double)MAX_int64 rounds up to 2^63, which no longer fits
+		return dValue >= (double)MAX_int64 ? MAX_int64 : dValue <= (double)MIN_int64 ? MIN_int64 : (int64)dValue;
+	}
+
+	static uint64 UInt64From(JsValueRef Value)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::UInt64From %p"), Value);
+		JsValueType Type = JsUndefined;
+		JsGetValueType(Value, &Type);
+		if (Type == JsString)
+		{
+			return FCString::Strtoui64(*StringFromChakra(Value), nullptr, 10);
+		}
+
+		const double dValue = DoubleFrom(Value);
+		if (!FMath::IsFinite(dValue) || dValue <= 0)
+		{
+			return 0;
+		}
+		return dValue >= (double)MAX_uint64 ? MAX_uint64 : (uint64)dValue;
+	}
+
 	static bool BoolFrom(JsValueRef Value)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::BoolFrom %p"), Value);
@@ -282,20 +356,19 @@ namespace chakra
 	static JsPropertyIdRef PropertyID(const char* ID)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::PropertyID(char)"));
-		JsPropertyIdRef PropID = JS_INVALID_REFERENCE;
-		JsCheck(JsCreatePropertyId(ID, FCStringAnsi::Strlen(ID), &PropID));
-
-		return PropID;
+		return InternPropertyID(ID);
 	}
 
 	static JsPropertyIdRef PropertyID(const FString& ID)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::PropertyID '%s'"), *ID);
-		JsPropertyIdRef PropID = JS_INVALID_REFERENCE;
-		FTCHARToUTF8 propIDStr(*ID);
-		JsCheck(JsCreatePropertyId(propIDStr.Get(), propIDStr.Length(), &PropID));
+		return InternPropertyID(ID);
+	}
 
-		return PropID;
+	static JsPropertyIdRef PropertyID(UProperty* Property)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::PropertyID(UProperty)"));
+		return InternPropertyID(Property);
 	}
 
 	static JsValueType GetType(JsValueRef Value)
@@ -325,6 +398,15 @@ namespace chakra
 		return Property;
 	}
 
+	static JsValueRef GetProperty(JsValueRef Value, UProperty* Property)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::GetProperty(UProperty) %p"), Value);
+		JsValueRef Result = JS_INVALID_REFERENCE;
+		JsCheck(JsGetProperty(Value, PropertyID(Property), &Result));
+
+		return Result;
+	}
+
 	static void SetProperty(JsValueRef Object, const char* Name, JsValueRef Prop)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::SetProperty(char) %p"), Object);
@@ -337,6 +419,12 @@ namespace chakra
 		JsCheck(JsSetProperty(Object, PropertyID(Name), Prop, true));
 	}
 
+	static void SetProperty(JsValueRef Object, UProperty* Property, JsValueRef Prop)
+	{
+		UE_LOG(Javascript, Verbose, TEXT("chakra::SetProperty(UProperty) %p"), Object);
+		JsCheck(JsSetProperty(Object, PropertyID(Property), Prop, true));
+	}
+
 	static JsValueRef GetPrototype(JsValueRef Value)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::GetPrototype %p"), Value);
@@ -364,7 +452,7 @@ namespace chakra
 	static int Length(JsValueRef MaybeArray)
 	{
 		UE_LOG(Javascript, Verbose, TEXT("chakra::Length %p"), MaybeArray);
-		if (!IsArray(MaybeArray))
+		if (!IsArray(MaybeArray) && !IsTypedArray(MaybeArray))
 			return 0;
 
 		int length = 0;
@@ -26,8 +26,8 @@ void UJavascriptComponent::OnRegister()
 		if (GetWorld() && ((GetWorld()->IsGameWorld() && !GetWorld()->IsPreviewWorld()) || bActiveWithinEditor))
 		{
 			double start = FPlatformTime::Seconds();
-			auto Context = NewObject<UJavascriptContext>();
-			UE_LOG(Javascript, Log, TEXT("took %.2lfs to create context"), FPlatformTime::Seconds() - start);
+			auto Context = IV8::Get().AcquireContext(RuntimeProfile);
+			UE_LOG(Javascript, Log, TEXT("took %.2lfs to acquire context"), FPlatformTime::Seconds() - start);
 
 			JavascriptContext = Context;
 
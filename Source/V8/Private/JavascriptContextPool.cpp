@@ -0,0 +1,160 @@
+#include "JavascriptContextPool.h"
+#include "JavascriptContext.h"
+#include "JavascriptSettings.h"
+#include "JavascriptStats.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+#include "Engine/World.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+static TAutoConsoleVariable<int32> CVarContextPoolRefill(
+	TEXT("javascript.ContextPool.Refill"),
+	0,
+	TEXT("Also refill context pools which were drawn from in the ticker, one context per tick. Off by default: each refill costs a full context startup ")
+	TEXT("(plus the pooled bootstrap script) in the middle of a frame, which only moves the hitch one frame later. Pools are refilled on map loads and Prewarm"));
+
+namespace
+{
+	template <typename Fn>
+	void ForEachPooledProfile(Fn&& Callback)
+	{
+		const UJavascriptSettings& Settings = *GetDefault<UJavascriptSettings>();
+		if (Settings.DefaultRuntimeProfile.PooledContexts > 0)
+		{
+			Callback(Settings.DefaultRuntimeProfile);
+		}
+
+		for (const auto& Profile : Settings.RuntimeProfiles)
+		{
+			if (Profile.PooledContexts > 0)
+			{
+				Callback(Profile);
+			}
+		}
+	}
+}
+
+FJavascriptContextPool::FJavascriptContextPool()
+{
+	TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FJavascriptContextPool::HandleTicker));
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FJavascriptContextPool::HandlePostLoadMap);
+}
+
+FJavascriptContextPool::~FJavascriptContextPool()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+}
+
+UJavascriptContext* FJavascriptContextPool::Acquire(FName Profile)
+{
+	const FJavascriptRuntimeProfile& RuntimeProfile = GetDefault<UJavascriptSettings>()->FindRuntimeProfile(Profile);
+	if (RuntimeProfile.PooledContexts > 0)
+	{
+		Drained.Add(RuntimeProfile.Name);
+
+		if (auto Pool = Pools.Find(RuntimeProfile.Name))
+		{
+			while (Pool->Num())
+			{
+				UJavascriptContext* Context = Pool->Pop(false);
+				if (Context && !Context->IsPendingKill())
+				{
+					UpdateStats();
+					return Context;
+				}
+			}
+		}
+
+		UE_LOG(Javascript, Log, TEXT("Context pool of profile '%s' is empty, creating a context"), *RuntimeProfile.Name.ToString());
+	}
+
+	return UJavascriptContext::CreateWithProfile(GetTransientPackage(), Profile);
+}
+
+void FJavascriptContextPool::Prewarm()
+{
+	int32 Created = 0;
+	ForEachPooledProfile([&](const FJavascriptRuntimeProfile& Profile) {
+		Created += Fill(Profile, MAX_int32);
+	});
+	Drained.Empty();
+
+	if (Created)
+	{
+		UE_LOG(Javascript, Log, TEXT("Prewarmed %d pooled contexts"), Created);
+	}
+}
+
+int32 FJavascriptContextPool::Fill(const FJavascriptRuntimeProfile& Profile, int32 MaxContexts)
+{
+	auto& Pool = Pools.FindOrAdd(Profile.Name);
+
+	int32 Created = 0;
+	while (Pool.Num() < Profile.PooledContexts && Created < MaxContexts)
+	{
+		UJavascriptContext* Context = UJavascriptContext::CreateWithProfile(GetTransientPackage(), Profile.Name);
+		if (!Profile.PooledBootstrapScript.IsEmpty())
+		{
+			Context->RunFile(Profile.PooledBootstrapScript);
+		}
+
+		Pool.Add(Context);
+		Created++;
+	}
+
+	UpdateStats();
+	return Created;
+}
+
+bool FJavascriptContextPool::HandleTicker(float DeltaTime)
+{
+	if (Drained.Num() == 0 || !CVarContextPoolRefill.GetValueOnGameThread())
+	{
+		return true;
+	}
+
+	// one context per tick, spread over frames; each still costs a whole context startup
+	for (auto It = Drained.CreateIterator(); It; ++It)
+	{
+		const FJavascriptRuntimeProfile& Profile = GetDefault<UJavascriptSettings>()->FindRuntimeProfile(*It);
+		if (Fill(Profile, 1) > 0)
+		{
+			return true;
+		}
+		It.RemoveCurrent();
+	}
+
+	return true;
+}
+
+void FJavascriptContextPool::HandlePostLoadMap(UWorld* World)
+{
+	// the loading screen is still up
+	if (World && World->IsGameWorld())
+	{
+		Prewarm();
+	}
+}
+
+void FJavascriptContextPool::UpdateStats() const
+{
+	int32 Num = 0;
+	for (const auto& Pair : Pools)
+	{
+		Num += Pair.Value.Num();
+	}
+	SET_DWORD_STAT(STAT_JavascriptPooledContexts, Num);
+}
+
+void FJavascriptContextPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (auto& Pair : Pools)
+	{
+		Collector.AddReferencedObjects(Pair.Value);
+	}
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "V8PCH.h"
+#include "UObject/GCObject.h"
+
+class UJavascriptContext;
+struct FJavascriptRuntimeProfile;
+
+// Contexts created ahead of time per runtime profile (PooledContexts in UJavascriptSettings), so that
+// components spawned during play don't pay for creating and bootstrapping a context of their own.
+// A context is handed out once and never comes back: one which ran scripts can't be brought back to a
+// clean global state, so the pool is refilled with fresh contexts instead, on map loads (while the loading
+// screen is up) and PrewarmContexts. Refilling during play is opt-in as it costs a context startup per frame.
+class FJavascriptContextPool : public FGCObject
+{
+public:
+	FJavascriptContextPool();
+	virtual ~FJavascriptContextPool();
+
+	// A ready context of the profile, or a new one when its pool is empty
+	UJavascriptContext* Acquire(FName Profile);
+
+	// Fills every pool right away, e.g. while a loading screen is up
+	void Prewarm();
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+private:
+	bool HandleTicker(float DeltaTime);
+	void HandlePostLoadMap(UWorld* World);
+
+	// Tops up one pool, at most MaxContexts new contexts; returns the number created
+	int32 Fill(const FJavascriptRuntimeProfile& Profile, int32 MaxContexts);
+
+	void UpdateStats() const;
+
+	/** Ready contexts per profile name */
+	TMap<FName, TArray<UJavascriptContext*>> Pools;
+
+	/** Profiles drawn from since the last fill, refilled from the ticker if javascript.ContextPool.Refill is on */
+	TSet<FName> Drained;
+
+	FDelegateHandle TickHandle;
+	FDelegateHandle PostLoadMapHandle;
+};
@@ -21,7 +21,15 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Engine/World.h"
 #include "Engine/UserDefinedStruct.h"
-#include "ScopedArguments.h"
+#include "Misc/ScopeExit.h"
+#include "JavascriptTaskScheduler.h"
+#include "JavascriptTimerWheel.h"
+#include "JavascriptRuntimeMemory.h"
+#include "WrapperCensus.h"
+#include "BoundaryProfiler.h"
+#include "JavascriptTrace.h"
+#include "JavascriptStartup.h"
+#include "JavascriptRuntimeBindings.h"
 #include "ScriptMacros.h"
 #include "Blueprint/UserWidget.h"
 #include "Internationalization/StringTableRegistry.h"
@@ -39,6 +47,9 @@
 #include "JavascriptWidgetGeneratedClass_Native.h"
 #include "JavascriptGeneratedFunction.h"
 #include "StructMemoryInstance.h"
+#include "MathStructs.h"
+#include "ModuleCache.h"
+#include "JavascriptWorker.h"
 
 #include "JavascriptStats.h"
 
@@ -57,6 +68,9 @@ static UClass* PlaceholderUClass;
 // for UStructProperty
 struct FStructDummy {};
 
+// for UNumericProperty of any width, converted through the property itself
+struct FNumericDummy {};
+
 template<>
 FObjectInitializer const& FObjectInitializer::SetDefaultSubobjectClass<hack_private_key>(TCHAR const*SubobjectName) const
 {
@@ -95,20 +109,6 @@ static FString URLToLocalPath(FString URL)
 	return URL;
 }
 
-FString PropertyNameToString(UProperty* Property)
-{
-	auto Struct = Property->GetOwnerStruct();
-	auto name = Property->GetFName();
-	if (Struct)
-	{
-		if (auto s = Cast<UUserDefinedStruct>(Struct))
-		{
-			return s->PropertyNameToDisplayName(name);
-		}
-	}
-	return name.ToString();
-}
-
 bool MatchPropertyName(UProperty* Property, FName NameToMatch)
 {
 	auto Struct = Property->GetOwnerStruct();
@@ -861,11 +861,17 @@ class FJavascriptContextImplementation : public FJavascriptContext
 	// Allocator instance should be set for V8's ArrayBuffer's
 	//FMallocArrayBufferAllocator AllocatorInstance;
 
-	bool bGCRequested;
 	FTickerDelegate TickDelegate;
 	FDelegateHandle TickHandle;
 	bool RunInGameThread;
-	TArray<JsValueRef> PromiseTasks;
+	FJavascriptTaskScheduler TaskScheduler;
+	FJavascriptTimerWheel TimerWheel;
+	JsRuntimeHandle Runtime;
+	FJavascriptRuntimeBindings& Bindings;
+	int32 SeenSoftLimitSerial{ 0 };
+	FJavascriptWrapperCensus WrapperCensus;
+	TSharedPtr<const FJavascriptLibraryMapping> LibraryMapping;
+	TArray<TSharedRef<const FPropertyAccessor>> ExportedAccessors;
 
 
 	virtual const FObjectInitializer* GetObjectInitializer() override
@@ -888,6 +894,15 @@ public:
 
 public:
 
+	// Memory and owner ExportStructInstance hands over to the struct constructor
+	struct FPendingStructSource
+	{
+		uint8* Buffer;
+		const IPropertyOwner* Owner;
+	};
+
+	FPendingStructSource* PendingStructSource = nullptr;
+
 	struct FObjectPropertyAccessors
 	{
 		static void* This(JsValueRef self)
@@ -895,27 +910,27 @@ public:
 			return chakra::UObjectFromChakra(self);
 		}
 
-		static JsValueRef Get(FJavascriptContext* ctx, JsValueRef self, UProperty* Property)
+		static JsValueRef Get(FJavascriptContext* ctx, JsValueRef self, const FPropertyAccessor& Accessor)
 		{
 			UObject* Object = chakra::UObjectFromChakra(self);
+			UProperty* Property = Accessor.Property;
 
-			if (Object->IsValidLowLevelFast() && Property->IsValidLowLevelFast())
+			if (Object && Property->IsValidLowLevelFast())
 			{
 				FScopeCycleCounterUObject ContextScope(Object);
 				FScopeCycleCounterUObject PropertyScope(Property);
 				SCOPE_CYCLE_COUNTER(STAT_JavascriptPropertyGet);
+				FJavascriptBoundaryScope BoundaryScope(EJavascriptBoundary::PropertyGet, Property);
 
-				if (auto p = Cast<UMulticastDelegateProperty>(Property))
-				{
-					return static_cast<FJavascriptContextImplementation*>(ctx)->Delegates->GetProxy(self, Object, p);
-				}
-				else if (auto p = Cast<UDelegateProperty>(Property))
+				auto Impl = static_cast<FJavascriptContextImplementation*>(ctx);
+				switch (Accessor.Kind)
 				{
-					return static_cast<FJavascriptContextImplementation*>(ctx)->Delegates->GetProxy(self, Object, p);
-				}
-				else
-				{
-					return ctx->ReadProperty(Property, (uint8*)Object, FObjectPropertyOwner(Object));
+				case EPropertyAccessorKind::MulticastDelegate:
+					return Impl->Delegates->GetProxy(self, Object, static_cast<UMulticastDelegateProperty*>(Property));
+				case EPropertyAccessorKind::Delegate:
+					return Impl->Delegates->GetProxy(self, Object, static_cast<UDelegateProperty*>(Property));
+				default:
+					return Impl->ReadProperty(Accessor, (uint8*)Object, FObjectPropertyOwner(Object));
 				}
 			}
 			else
@@ -924,10 +939,10 @@ public:
 			}
 		}
 
-		//@TODO : Property-type 'routing' is not necessary!
-		static void Set(FJavascriptContext* ctx, JsValueRef self, UProperty* Property, JsValueRef value)
+		static void Set(FJavascriptContext* ctx, JsValueRef self, const FPropertyAccessor& Accessor, JsValueRef value)
 		{
 			UObject* Object = chakra::UObjectFromChakra(self);
+			UProperty* Property = Accessor.Property;
 
 			// Direct access to delegate
 			auto SetDelegate = [&](JsValueRef proxy) {
@@ -970,27 +985,25 @@ public:
 				}
 			};
 
-			if (Object->IsValidLowLevelFast())
+			if (Object)
 			{
 				FScopeCycleCounterUObject ContextScope(Object);
 				FScopeCycleCounterUObject PropertyScope(Property);
 				SCOPE_CYCLE_COUNTER(STAT_JavascriptPropertySet);
+				FJavascriptBoundaryScope BoundaryScope(EJavascriptBoundary::PropertySet, Property);
 
-				// Multicast delegate
-				if (auto p = Cast<UMulticastDelegateProperty>(Property))
-				{
-					auto proxy = static_cast<FJavascriptContextImplementation*>(ctx)->Delegates->GetProxy(self, Object, p);
-					SetDelegate(proxy);
-				}
-				// delegate
-				else if (auto p = Cast<UDelegateProperty>(Property))
-				{
-					auto proxy = static_cast<FJavascriptContextImplementation*>(ctx)->Delegates->GetProxy(self, Object, p);
-					SetDelegate(proxy);
-				}
-				else
+				auto Impl = static_cast<FJavascriptContextImplementation*>(ctx);
+				switch (Accessor.Kind)
 				{
-					ctx->WriteProperty(Property, (uint8*)Object, value);
+				case EPropertyAccessorKind::MulticastDelegate:
+					SetDelegate(Impl->Delegates->GetProxy(self, Object, static_cast<UMulticastDelegateProperty*>(Property)));
+					break;
+				case EPropertyAccessorKind::Delegate:
+					SetDelegate(Impl->Delegates->GetProxy(self, Object, static_cast<UDelegateProperty*>(Property)));
+					break;
+				default:
+					Impl->WriteProperty(Accessor, (uint8*)Object, value);
+					break;
 				}
 			}
 		}
@@ -1003,12 +1016,12 @@ public:
 			return FStructMemoryInstance::FromChakra(self)->GetMemory();
 		}
 
-		static JsValueRef Get(FJavascriptContext* context, JsValueRef self, UProperty* Property)
+		static JsValueRef Get(FJavascriptContext* context, JsValueRef self, const FPropertyAccessor& Accessor)
 		{
 			auto Instance = FStructMemoryInstance::FromChakra(self);
 			if (Instance)
 			{
-				return context->ReadProperty(Property, Instance->GetMemory(), FStructMemoryPropertyOwner(Instance));
+				return static_cast<FJavascriptContextImplementation*>(context)->ReadProperty(Accessor, Instance->GetMemory(), FStructMemoryPropertyOwner(Instance));
 			}
 			else
 			{
@@ -1016,12 +1029,12 @@ public:
 			}
 		}
 
-		static void Set(FJavascriptContext* context, JsValueRef self, UProperty* Property, JsValueRef value)
+		static void Set(FJavascriptContext* context, JsValueRef self, const FPropertyAccessor& Accessor, JsValueRef value)
 		{
 			auto Instance = FStructMemoryInstance::FromChakra(self);
 			if (Instance)
 			{
-				context->WriteProperty(Property, Instance->GetMemory(), value);
+				static_cast<FJavascriptContextImplementation*>(context)->WriteProperty(Accessor, Instance->GetMemory(), value);
 			}
 			else
 			{
@@ -1037,8 +1050,74 @@ public:
 		FString Path;
 	};
 
+	// Resolved proxy functions per holder object. Once a holder is cached its 'proxy' becomes an accessor
+	// backed by the entry, so assigning a new proxy replaces the entry and dispatch never has to look it up.
+	struct FProxyFunctionCache
+	{
+		struct FEntry
+		{
+			FEntry(FName InName, JsValueRef InFunction) : Name(InName), Function(InFunction) {}
+			FName Name;
+			Persistent<JsValueRef> Function;
+		};
+
+		FProxyFunctionCache(JsValueRef InProxy) : Proxy(InProxy) {}
+		Persistent<JsValueRef> Proxy;
+		TMap<UFunction*, FEntry> Functions;
+	};
+
+	TMap<UObject*, TSharedPtr<FProxyFunctionCache>> ProxyFunctionCache;
+
+	// FJavascriptFunction/FJavascriptRef handles given to native code, which may outlive this context and its runtime
+	template <typename HandleType>
+	struct TExportedHandles
+	{
+		TArray<TWeakPtr<HandleType>> Handles;
+		int32 CompactAt = 64;
+
+		void Add(const TSharedPtr<HandleType>& Handle)
+		{
+			// keep the array proportional to the handles still alive
+			if (Handles.Num() >= CompactAt)
+			{
+				Handles.RemoveAllSwap([](const TWeakPtr<HandleType>& Weak) { return !Weak.IsValid(); });
+				CompactAt = FMath::Max(64, Handles.Num() * 2);
+			}
+			Handles.Add(Handle);
+		}
+	};
+
+	TExportedHandles<FPrivateJavascriptFunction> ExportedFunctions;
+	TExportedHandles<FPrivateJavascriptRef> ExportedRefs;
+	Persistent<JsValueRef> ProxyGetter;
+	Persistent<JsValueRef> ProxySetter;
+
+	// Workers created by script, pumped from HandleTicker
+	struct FWorkerEntry
+	{
+		FWorkerEntry(JsValueRef InObject, const TSharedPtr<FJavascriptWorker>& InWorker) : Object(InObject), Worker(InWorker) {}
+		Persistent<JsValueRef> Object;
+		TSharedPtr<FJavascriptWorker> Worker;
+	};
+
+	TMap<int32, TSharedPtr<FWorkerEntry>> Workers;
+	int32 NextWorkerId = 1;
+
+	// Keeps the struct instance whose memory an external ArrayBuffer aliases alive until chakra finalizes the buffer
+	struct FExternalArrayOwner
+	{
+		TSharedPtr<FStructMemoryInstance> Memory;
+	};
+
+	// Object.seal, looked up once for sealing fixed size arrays
+	Persistent<JsValueRef> ArraySealer;
+
 	int NextModuleSourceContext = 1;
+	TMap<JsSourceContext, FString> SerializedModuleSources; // sources of modules loaded from the module cache, until chakra asks for them
+	TMap<FString, JsSourceContext> SerializedModuleSourceContexts; // latest source context per module path
 	TMap<FString, TSharedPtr<FJavascriptModule>> Modules;
+	TSet<FString> MissingTypes; // names FindTypeToExport found nothing for, as of MissingTypesGeneration
+	uint32 MissingTypesGeneration = 0;
 	TArray<FString>& Paths;
 	bool bInlineExecution = false;
 	int RequireDepth = 0;
@@ -1088,19 +1167,30 @@ public:
 
 	void EnqueuePromiseTask(JsValueRef Task)
 	{
-		JsCheck(JsAddRef(Task, nullptr));
-		PromiseTasks.Add(Task);
+		TaskScheduler.Enqueue(Task, EJavascriptTaskPriority::Microtask);
 	}
 
 	FJavascriptContextImplementation(JsRuntimeHandle InRuntime, TArray<FString>& InPaths)
-		: bGCRequested(false)
+		: Runtime(InRuntime)
+		, Bindings(*FJavascriptRuntimeBindings::Find(InRuntime))
 		, Paths(InPaths)
 	{
 		check(InRuntime != JS_INVALID_RUNTIME_HANDLE);
 
+		FJavascriptTraceScope TraceScope(TEXT("CreateContext"));
+
 		JsContextRef context = JS_INVALID_REFERENCE;
-		JsCheck(JsCreateContext(InRuntime, &context));
-		JsCheck(JsSetContextData(context, this));
+		{
+			FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::CreateContext);
+			JsCheck(JsCreateContext(InRuntime, &context));
+			JsCheck(JsSetContextData(context, this));
+		}
+
+		if (auto Memory = FJavascriptRuntimeMemory::Find(Runtime))
+		{
+			Memory->AddContext(context);
+			SeenSoftLimitSerial = Memory->GetSoftLimitSerial();
+		}
 
 		context_.Reset(context);
 
@@ -1110,9 +1200,10 @@ public:
 		// Bind this instance to newly created V8 isolate
 		Delegates = IDelegateManager::Create();
 
-		GenerateBlueprintFunctionLibraryMapping();
-
-		InitializeGlobalTemplate();
+		{
+			FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::InitializeGlobalTemplate);
+			InitializeGlobalTemplate();
+		}
 
 		TickDelegate = FTickerDelegate::CreateRaw(this, &FJavascriptContextImplementation::HandleTicker);
 		TickHandle = FTicker::GetCoreTicker().AddTicker(TickDelegate);
@@ -1131,6 +1222,16 @@ public:
 
 		PurgeModules();
 
+		TerminateWorkers();
+
+		TaskScheduler.Reset();
+		TimerWheel.Reset();
+
+		if (auto Memory = FJavascriptRuntimeMemory::Find(Runtime))
+		{
+			Memory->RemoveContext(context_.Get());
+		}
+
 		ReleaseAllPersistentHandles();
 
 		ResetAsDebugContext();
@@ -1149,9 +1250,32 @@ public:
 	{
 		// Release all object instances
 		ObjectToObjectMap.Empty();
+		ProxyFunctionCache.Empty();
+
+		// isolated runtimes are disposed right after the context; handles left behind must not release into them
+		for (const auto& Weak : ExportedFunctions.Handles)
+		{
+			if (auto Handle = Weak.Pin())
+			{
+				Handle->Function.Reset();
+				Handle->context.Reset();
+			}
+		}
+		ExportedFunctions.Handles.Empty();
+
+		for (const auto& Weak : ExportedRefs.Handles)
+		{
+			if (auto Handle = Weak.Pin())
+			{
+				Handle->Object.Reset();
+			}
+		}
+		ExportedRefs.Handles.Empty();
 
 		// Release all struct instances
-		MemoryToObjectMap.Empty();
+		StructInstances.Empty();
+		StructInstanceTypes.Empty();
+		WrapperCensus.Reset();
 
 		// Release all exported classes
 		ClassToFunctionTemplateMap.Empty();
@@ -1161,6 +1285,10 @@ public:
 
 		// Release global template
 		GlobalTemplate.Reset();
+
+		ArraySealer.Reset();
+		ProxyGetter.Reset();
+		ProxySetter.Reset();
 	}
 
 	void InitializeGlobalTemplate()
@@ -1175,23 +1303,7 @@ public:
 		// Save it into the persistant handle
 		GlobalTemplate.Reset(ObjectTemplate);
 
-		// Export all structs
-		for (TObjectIterator<UScriptStruct> It; It; ++It)
-		{
-			ExportStruct(*It);
-		}
-
-		// Export all classes
-		for (TObjectIterator<UClass> It; It; ++It)
-		{
-			ExportClass(*It);
-		}
-
-		// Export all enums
-		for (TObjectIterator<UEnum> It; It; ++It)
-		{
-			ExportEnum(*It);
-		}
+		// Structs, classes and enums are exported on demand (see ExposeTypeResolver)
 
 		ExportText(ObjectTemplate);
 
@@ -1213,9 +1325,18 @@ public:
 			reinterpret_cast<FJavascriptContextImplementation*>(callbackState)->EnqueuePromiseTask(Task);
 		}, this));
 
-		CopyGlobalTemplate();
+		{
+			FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::CopyGlobalTemplate);
+			CopyGlobalTemplate();
+		}
+
+		FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::ExposeGlobals);
+		ExposeTypeResolver();
 		ExposeGlobalObject();
 		ExposeRequire();
+		ExposeWorker();
+		ExposeScheduler();
+		ExposeTimers();
 		ExportUnrealEngineClasses();
 		ExportUnrealEngineStructs();
 
@@ -1225,6 +1346,8 @@ public:
 	void PurgeModules()
 	{
 		Modules.Empty();
+		SerializedModuleSources.Empty();
+		SerializedModuleSourceContexts.Empty();
 	}
 
 	void PauseTick() override
@@ -1239,64 +1362,148 @@ public:
 		RunInGameThread = true;
 	}
 
-	void GenerateBlueprintFunctionLibraryMapping()
+	void ExportAllTypes()
 	{
+		FContextScope ContextScope(context());
+
+		// Export all structs
+		for (TObjectIterator<UScriptStruct> It; It; ++It)
+		{
+			ExportStruct(*It);
+		}
+
+		// Export all classes
 		for (TObjectIterator<UClass> It; It; ++It)
 		{
-			UClass* Class = *It;
+			ExportClass(*It);
+		}
 
-			// Blueprint function library only
-			if (Class->IsChildOf(UBlueprintFunctionLibrary::StaticClass()))
-			{
-				// Iterate over all functions
-				for (TFieldIterator<UFunction> FuncIt(Class, EFieldIteratorFlags::ExcludeSuper); FuncIt; ++FuncIt)
-				{
-					auto Function = *FuncIt;
-					TFieldIterator<UProperty> It(Function);
+		// Export all enums
+		for (TObjectIterator<UEnum> It; It; ++It)
+		{
+			ExportEnum(*It);
+		}
+	}
 
-					// It should be a static function 
-					if ((Function->FunctionFlags & FUNC_Static) && It)
-					{
-						// and have first argument to bind with.
-						if ((It->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm)
-						{
-							// The first argument should be type of object
-							if (auto p = Cast<UObjectPropertyBase>(*It))
-							{
-								auto TargetClass = p->PropertyClass;
+	UField* FindTypeToExport(const FString& Name)
+	{
+		// FindObject is not allowed while GC is running or packages are being saved
+		if (IsGarbageCollecting() || GIsSavingPackage)
+		{
+			return nullptr;
+		}
 
-								// GetWorld() may fail and crash, so target class is bound to UWorld
-								if (TargetClass == UObject::StaticClass() && (p->GetName() == TEXT("WorldContextObject") || p->GetName() == TEXT("WorldContext")))
-								{
-									TargetClass = UWorld::StaticClass();
-								}
+		// names script touched that aren't types (globals tested with typeof, typos) would search every package each time
+		const uint32 TypesGeneration = FJavascriptRuntimeBindings::GetTypesGeneration();
+		if (TypesGeneration != MissingTypesGeneration)
+		{
+			MissingTypes.Reset();
+			MissingTypesGeneration = TypesGeneration;
+		}
+		if (MissingTypes.Contains(Name))
+		{
+			return nullptr;
+		}
 
-								BlueprintFunctionLibraryMapping.Add(TargetClass, Function);
-								continue;
-							}
-							else if (auto p = Cast<UStructProperty>(*It))
-							{
-								BlueprintFunctionLibraryMapping.Add(p->Struct, Function);
-								continue;
-							}
-						}
+		FString TypeName = FV8Config::Unsafeify(Name);
+		if (TypeName.IsEmpty() || !FName::IsValidXName(TypeName, INVALID_OBJECTNAME_CHARACTERS))
+		{
+			MissingTypes.Add(Name);
+			return nullptr;
+		}
 
-						// Factory function?
-						for (auto It2 = It; It2; ++It2)
-						{
-							if ((It2->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == (CPF_Parm | CPF_ReturnParm))
-							{
-								if (auto p = Cast<UStructProperty>(*It2))
-								{
-									BlueprintFunctionLibraryFactoryMapping.Add(p->Struct, Function);
-									break;
-								}
-							}
-						}
-					}
-				}
+		// Same precedence as the former eager export : enum over class over struct
+		if (UEnum* Enum = FindObject<UEnum>(ANY_PACKAGE, *TypeName))
+		{
+			return Enum;
+		}
+		else if (UClass* Class = FindObject<UClass>(ANY_PACKAGE, *TypeName))
+		{
+			return Class;
+		}
+		else if (UScriptStruct* Struct = FindObject<UScriptStruct>(ANY_PACKAGE, *TypeName))
+		{
+			return Struct;
+		}
+
+		MissingTypes.Add(Name);
+		return nullptr;
+	}
+
+	JsValueRef ResolveType(const FString& Name)
+	{
+		UField* Type = FindTypeToExport(Name);
+		if (UEnum* Enum = Cast<UEnum>(Type))
+		{
+			return ExportEnum(Enum);
+		}
+		else if (UClass* Class = Cast<UClass>(Type))
+		{
+			return ExportClass(Class);
+		}
+		else if (UScriptStruct* Struct = Cast<UScriptStruct>(Type))
+		{
+			return ExportStruct(Struct);
+		}
+		else
+		{
+			return chakra::Undefined();
+		}
+	}
+
+	// Global lookups which are not found on the global object fall through its prototype chain,
+	// so a proxy inserted there exports the type when a script touches its name for the first time.
+	// Exported types are registered on the global object itself and never hit the proxy again.
+	void ExposeTypeResolver()
+	{
+		auto fn = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+			auto Context = reinterpret_cast<FJavascriptContextImplementation*>(callbackState);
+			if (argumentCount < 2 || !chakra::IsString(arguments[1]))
+			{
+				return chakra::Undefined();
 			}
+
+			return Context->ResolveType(chakra::StringFromChakra(arguments[1]));
+		};
+
+		static const TCHAR Installer[] = TEXT(R"doc(
+(function (global, resolve) {
+    var target = Object.getPrototypeOf(global);
+    var lookup = function (key) { return typeof key === 'string' ? resolve(key) : undefined; };
+    Object.setPrototypeOf(global, new Proxy(target, {
+        has: function (target, key) { return key in target || lookup(key) !== undefined; },
+        get: function (target, key, receiver) { return key in target ? Reflect.get(target, key, receiver) : lookup(key); }
+    }));
+})
+)doc");
+
+		FContextScope scope(context());
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
+
+		JsValueRef install = RunScript(TEXT(""), Installer);
+		if (chakra::IsEmpty(install))
+		{
+			UE_LOG(Javascript, Error, TEXT("Failed to install lazy type resolver, exporting all types"));
+			ExportAllTypes();
+			return;
+		}
+
+		JsValueRef args[] = { global, global, chakra::FunctionTemplate(fn, this) };
+		JsValueRef result = JS_INVALID_REFERENCE;
+		JsCheck(JsCallFunction(install, args, 3, &result));
+	}
+
+	virtual const FJavascriptLibraryMapping& GetLibraryMapping() override
+	{
+		// Library functions are indexed once per runtime, when the first type gets exported, and again
+		// after blueprints were recompiled or classes reloaded
+		if (!LibraryMapping.IsValid() || !Bindings.IsCurrent(*LibraryMapping))
+		{
+			FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::BlueprintLibraryMapping);
+			LibraryMapping = Bindings.GetLibraryMapping();
 		}
+		return *LibraryMapping;
 	}
 
 	void ExportUnrealEngineClasses()
@@ -1781,9 +1988,14 @@ public:
 		FContextScope scope(context());
 
 		// @todo: using 'ForTesting' function
-		JsRuntimeHandle runtime = JS_INVALID_RUNTIME_HANDLE;
-		JsCheck(JsGetRuntime(context(), &runtime));
-		JsCheck(JsCollectGarbage(runtime));
+		if (auto Memory = FJavascriptRuntimeMemory::Find(Runtime))
+		{
+			Memory->GCScheduler.Collect(Runtime);
+		}
+		else
+		{
+			JsCheck(JsCollectGarbage(Runtime));
+		}
 	}
 
 	void ExportText(JsValueRef GlobalTemplate)
@@ -1936,6 +2148,277 @@ public:
 
 	JsValueRef RequireInternalFunc = JS_INVALID_REFERENCE;
 
+	void ExposeWorker()
+	{
+		auto fn = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+			auto Context = reinterpret_cast<FJavascriptContextImplementation*>(callbackState);
+
+			if (!isConstructCall || argumentCount < 2 || !chakra::IsString(arguments[1]))
+			{
+				chakra::Throw(TEXT("usage: new Worker(scriptPath)"));
+				return chakra::Undefined();
+			}
+
+			return Context->CreateWorker(arguments[0], chakra::StringFromChakra(arguments[1]));
+		};
+
+		FContextScope scope(context());
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
+
+		chakra::SetProperty(global, "Worker", chakra::FunctionTemplate(fn, this));
+	}
+
+	// scheduler.postTask(callback, { priority: 'user-blocking' | 'user-visible' | 'background' })
+	void ExposeScheduler()
+	{
+		auto fn = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+			auto Context = reinterpret_cast<FJavascriptContextImplementation*>(callbackState);
+
+			if (argumentCount < 2 || !chakra::IsFunction(arguments[1]))
+			{
+				chakra::Throw(TEXT("usage: scheduler.postTask(callback, options)"));
+				return chakra::Undefined();
+			}
+
+			auto Priority = EJavascriptTaskPriority::UserVisible;
+			if (argumentCount > 2 && chakra::IsObject(arguments[2]))
+			{
+				JsValueRef priority = chakra::GetProperty(arguments[2], "priority");
+				if (chakra::IsString(priority))
+				{
+					Priority = FJavascriptTaskScheduler::ParsePriority(chakra::StringFromChakra(priority));
+				}
+			}
+
+			Context->TaskScheduler.Enqueue(arguments[1], Priority);
+			return chakra::Undefined();
+		};
+
+		FContextScope scope(context());
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
+
+		JsValueRef scheduler = JS_INVALID_REFERENCE;
+		JsCheck(JsCreateObject(&scheduler));
+		chakra::SetProperty(scheduler, "postTask", chakra::FunctionTemplate(fn, this));
+		chakra::SetProperty(global, "scheduler", scheduler);
+	}
+
+	void ExposeTimers()
+	{
+		// setTimeout(callback, delay, ...args), setInterval(callback, delay, ...args) and setImmediate(callback, ...args)
+		enum ETimerKind : uint8 { Timeout, Interval, Immediate };
+
+		auto set = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+			const auto Kind = (ETimerKind)(UPTRINT)callbackState;
+			if (argumentCount < 2 || !chakra::IsFunction(arguments[1]))
+			{
+				chakra::Throw(TEXT("timer callback must be a function"));
+				return chakra::Undefined();
+			}
+
+			const int32 FirstArgument = Kind == Immediate ? 2 : 3;
+			double Delay = 0;
+			if (Kind != Immediate && argumentCount > 2)
+			{
+				// Number(delay), like the polyfill did; '100' waits 100ms, NaN becomes 0 below
+				JsValueRef Number = JS_INVALID_REFERENCE;
+				if (JsConvertValueToNumber(arguments[2], &Number) != JsNoError)
+				{
+					// valueOf threw, leave the exception pending for the caller
+					return chakra::Undefined();
+				}
+				Delay = chakra::DoubleFrom(Number);
+			}
+			Delay = FMath::IsFinite(Delay) ? FMath::Clamp(Delay, 0.0, (double)MAX_int32) : 0.0;
+
+			JsValueRef Arguments = JS_INVALID_REFERENCE;
+			if (argumentCount > FirstArgument)
+			{
+				JsCheck(JsCreateArray(argumentCount - FirstArgument, &Arguments));
+				for (int32 Index = FirstArgument; Index < argumentCount; ++Index)
+				{
+					chakra::SetIndex(Arguments, Index - FirstArgument, arguments[Index]);
+				}
+			}
+
+			// repeating timers are clamped like browsers do
+			const uint32 DelayInMs = (uint32)Delay;
+			const uint32 IntervalInMs = Kind == Interval ? FMath::Max<uint32>(DelayInMs, 4) : 0;
+
+			auto Context = GetFrom(callee);
+			return chakra::Int(Context->TimerWheel.Add(arguments[1], Arguments, DelayInMs, IntervalInMs));
+		};
+
+		// all kinds of timers share their handles
+		auto clear = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+			if (argumentCount > 1 && chakra::IsNumber(arguments[1]))
+			{
+				GetFrom(callee)->TimerWheel.Remove(chakra::IntFrom(arguments[1]));
+			}
+			return chakra::Undefined();
+		};
+
+		FContextScope scope(context());
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
+
+		chakra::SetProperty(global, "setTimeout", chakra::FunctionTemplate(set, reinterpret_cast<void*>((UPTRINT)Timeout)));
+		chakra::SetProperty(global, "setInterval", chakra::FunctionTemplate(set, reinterpret_cast<void*>((UPTRINT)Interval)));
+		chakra::SetProperty(global, "setImmediate", chakra::FunctionTemplate(set, reinterpret_cast<void*>((UPTRINT)Immediate)));
+		chakra::SetProperty(global, "clearTimeout", chakra::FunctionTemplate(clear));
+		chakra::SetProperty(global, "clearInterval", chakra::FunctionTemplate(clear));
+		chakra::SetProperty(global, "clearImmediate", chakra::FunctionTemplate(clear));
+	}
+
+	JsValueRef CreateWorker(JsValueRef self, const FString& Filename)
+	{
+		FString ScriptPath = GetScriptFileFullPath(Filename);
+
+		FString Source;
+		if (!FFileHelper::LoadFileToString(Source, *ScriptPath))
+		{
+			chakra::Throw(FString::Printf(TEXT("Worker script not found: %s"), *Filename));
+			return chakra::Undefined();
+		}
+
+		auto Worker = MakeShared<FJavascriptWorker>(ScriptPath, Source, Paths);
+		if (!Worker->Start())
+		{
+			chakra::Throw(FString::Printf(TEXT("Failed to start worker: %s"), *Filename));
+			return chakra::Undefined();
+		}
+
+		const int32 WorkerId = NextWorkerId++;
+		Workers.Add(WorkerId, MakeShared<FWorkerEntry>(self, Worker));
+
+		// methods carry the worker id rather than a pointer, the worker may be gone by the time they're called
+		void* WorkerState = reinterpret_cast<void*>((UPTRINT)WorkerId);
+
+		chakra::SetProperty(self, "postMessage", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+			auto Context = GetFrom(callee);
+			auto Entry = Context->Workers.Find((int32)(UPTRINT)callbackState);
+			if (Entry == nullptr)
+			{
+				chakra::Throw(TEXT("Worker has been terminated"));
+				return chakra::Undefined();
+			}
+
+			FString Message;
+			if (FJavascriptWorker::Serialize(argumentCount > 1 ? arguments[1] : chakra::Undefined(), Message))
+			{
+				(*Entry)->Worker->PostMessage(Message);
+			}
+
+			return chakra::Undefined();
+		}, WorkerState));
+
+		chakra::SetProperty(self, "terminate", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+			auto Context = GetFrom(callee);
+			TSharedPtr<FWorkerEntry> Entry;
+			if (Context->Workers.RemoveAndCopyValue((int32)(UPTRINT)callbackState, Entry))
+			{
+				Entry->Worker->Terminate();
+			}
+
+			return chakra::Undefined();
+		}, WorkerState));
+
+		return self;
+	}
+
+	void PumpWorkers()
+	{
+		if (Workers.Num() == 0)
+		{
+			return;
+		}
+
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
+
+		// handlers may create or terminate workers
+		TArray<int32> WorkerIds;
+		Workers.GenerateKeyArray(WorkerIds);
+
+		for (int32 WorkerId : WorkerIds)
+		{
+			auto Found = Workers.Find(WorkerId);
+			if (Found == nullptr)
+			{
+				continue;
+			}
+
+			TSharedPtr<FWorkerEntry> Entry = *Found;
+			FJavascriptWorker* Worker = Entry->Worker.Get();
+
+			// check before draining so that messages posted right before close() are still delivered
+			const bool bFinished = Worker->IsFinished();
+
+			auto Dispatch = [&](const char* Handler, const char* Field, JsValueRef Value) {
+				JsValueRef Object = Entry->Object.Get();
+				JsValueRef Function = chakra::GetProperty(Object, Handler);
+				if (!chakra::IsFunction(Function))
+				{
+					return false;
+				}
+
+				JsValueRef Event = JS_INVALID_REFERENCE;
+				JsCheck(JsCreateObject(&Event));
+				chakra::SetProperty(Event, Field, Value);
+				chakra::SetProperty(Event, "target", Object);
+
+				JsValueRef args[] = { Object, Event };
+				JsValueRef result = JS_INVALID_REFERENCE;
+				if (JsCallFunction(Function, args, ARRAY_COUNT(args), &result) == JsErrorScriptException)
+				{
+					JsValueRef exception = JS_INVALID_REFERENCE;
+					JsCheck(JsGetAndClearException(&exception));
+					UncaughtException(FV8Exception::Report(exception));
+				}
+				return true;
+			};
+
+			FString Message;
+			while (Worker->PopMessage(Message))
+			{
+				JsValueRef Data = FJavascriptWorker::Deserialize(Message);
+				if (chakra::IsEmpty(Data))
+				{
+					JsValueRef exception = JS_INVALID_REFERENCE;
+					JsCheck(JsGetAndClearException(&exception));
+					continue;
+				}
+
+				Dispatch("onmessage", "data", Data);
+			}
+
+			FString Error;
+			while (Worker->PopError(Error))
+			{
+				if (!Dispatch("onerror", "message", chakra::String(Error)))
+				{
+					UE_LOG(Javascript, Error, TEXT("Worker %s: %s"), *Worker->GetScriptPath(), *Error);
+				}
+			}
+
+			if (bFinished)
+			{
+				Workers.Remove(WorkerId);
+			}
+		}
+	}
+
+	void TerminateWorkers()
+	{
+		for (auto& Pair : Workers)
+		{
+			Pair.Value->Worker->Terminate();
+		}
+		Workers.Empty();
+	}
+
 	void ExposeRequire()
 	{
 		FContextScope scope(context());
@@ -2007,6 +2490,8 @@ public:
 					return true;
 				}
 
+				FJavascriptTraceScope TraceScope(TEXT("require"), *relative_path);
+
 				FString Text;
 				if (FFileHelper::LoadFileToString(Text, *relative_path))
 				{
@@ -2020,11 +2505,11 @@ public:
 					JsCheck(JsCreateObject(&moduleSelf));
 					chakra::SetProperty(module, "exports", exports);
 
-					JsValueRef wrappedScript = chakra::String(TEXT("(function (exports, require, module, __filename, __dirname) {") + Text + TEXT("\n})"));
+					FString wrappedScript = TEXT("(function (exports, require, module, __filename, __dirname) {") + Text + TEXT("\n})");
 					//Text = FString::Printf(TEXT("(function (global, __filename, __dirname) { var module = { exports : {}, filename : __filename }, exports = module.exports, require = specifier => global.require(__filename, specifier); (function () { %s\n })();\nreturn module.exports;})(this,'%s', '%s');"), *Text, *relative_path, *FPaths::GetPath(relative_path));
 
 					// parse module func
-					JsValueRef moduleFunc = Self->RunScriptInternal(wrappedScript, relative_path, true);
+					JsValueRef moduleFunc = Self->RunModuleScript(wrappedScript, relative_path);
 					if (chakra::IsEmpty(moduleFunc))
 					{
 						UE_LOG(Javascript, Log, TEXT("Invalid script for require: %s"), *relative_path);
@@ -2417,21 +2902,51 @@ public:
 		});
 	}
 
+	// global onmemorypressure({ usage, softLimit, hardLimit }), called once the runtime's heap crosses its soft limit
+	void DispatchMemoryPressure(const FJavascriptRuntimeMemory& Memory)
+	{
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
+
+		JsValueRef Function = chakra::GetProperty(global, "onmemorypressure");
+		if (!chakra::IsFunction(Function))
+		{
+			UE_LOG(Javascript, Warning, TEXT("Javascript heap crossed its soft limit (%lld of %lld bytes)"), Memory.GetLiveBytes(), Memory.GetSoftLimit());
+			return;
+		}
+
+		JsValueRef Event = JS_INVALID_REFERENCE;
+		JsCheck(JsCreateObject(&Event));
+		chakra::SetProperty(Event, "usage", chakra::Double((double)Memory.GetLiveBytes()));
+		chakra::SetProperty(Event, "softLimit", chakra::Double((double)Memory.GetSoftLimit()));
+		chakra::SetProperty(Event, "hardLimit", chakra::Double((double)Memory.GetHardLimit()));
+
+		JsValueRef args[] = { global, Event };
+		JsValueRef result = JS_INVALID_REFERENCE;
+		if (JsCallFunction(Function, args, ARRAY_COUNT(args), &result) == JsErrorScriptException)
+		{
+			JsValueRef exception = JS_INVALID_REFERENCE;
+			JsCheck(JsGetAndClearException(&exception));
+			UncaughtException(FV8Exception::Report(exception));
+		}
+	}
+
 	bool HandleTicker(float DeltaTime)
 	{
 		if (!RunInGameThread) return true;
 
-		TArray<JsValueRef> tasksCopy(const_cast<const TArray<JsValueRef>&>(PromiseTasks));
-		PromiseTasks.Empty();
+		FJavascriptTraceScope TickScope(TEXT("Tick"));
+
+		// one budget per frame, shared by all contexts
+		const double StartTime = FPlatformTime::Seconds();
+		const double Budget = FJavascriptTaskScheduler::GetFrameBudgetLeft(IV8::Get().GetIdleTaskBudget());
 
 		FContextScope scope(context());
 		JsValueRef global = JS_INVALID_REFERENCE, dummy = JS_INVALID_REFERENCE;
 		JsCheck(JsGetGlobalObject(&global));
 
-		for (JsValueRef task : tasksCopy)
+		auto ReportException = [&]()
 		{
-			JsCheck(JsCallFunction(task, &global, 1, &dummy));
-
 			bool hasException = false;
 			JsCheck(JsHasException(&hasException));
 			if (hasException)
@@ -2444,15 +2959,55 @@ public:
 				FString stack = chakra::StringFromChakra(stackValue);
 				UncaughtException(strErr + " " + stack);
 			}
-			
-			JsCheck(JsRelease(task, nullptr));
+		};
+
+		// timers first, so that promises they settle are drained within the same tick
+		TimerWheel.Advance([&](JsValueRef callback, JsValueRef arguments)
+		{
+			TArray<JsValueRef, TInlineAllocator<8>> args;
+			args.Add(global);
+			if (arguments != JS_INVALID_REFERENCE)
+			{
+				const int32 NumArguments = chakra::Length(arguments);
+				for (int32 Index = 0; Index < NumArguments; ++Index)
+				{
+					args.Add(chakra::GetIndex(arguments, Index));
+				}
+			}
+
+			JsCallFunction(callback, args.GetData(), (unsigned short)args.Num(), &dummy);
+			ReportException();
+		});
+
+		{
+			FJavascriptTraceScope TraceScope(TEXT("DrainPromises"));
+			TaskScheduler.Run(Budget - (FPlatformTime::Seconds() - StartTime), [&](JsValueRef task)
+			{
+				// scheduler.postTask callbacks are user code and may throw
+				JsCallFunction(task, &global, 1, &dummy);
+				ReportException();
+			});
 		}
 
-		// do garbage colliction now
-		if (bGCRequested)
+		PumpWorkers();
+
+		FJavascriptTaskScheduler::ConsumeFrameBudget(FPlatformTime::Seconds() - StartTime);
+
+		FJavascriptRuntimeMemory::UpdateStats();
+		if (auto Memory = FJavascriptRuntimeMemory::Find(Runtime))
 		{
-			DoGarbageCollection();
-			bGCRequested = false;
+			if (Memory->GetSoftLimitSerial() != SeenSoftLimitSerial)
+			{
+				SeenSoftLimitSerial = Memory->GetSoftLimitSerial();
+				DispatchMemoryPressure(*Memory);
+
+				// whatever the handlers of all contexts let go of is reclaimed by a single collection
+				Memory->RequestCollection();
+			}
+
+			// the runtime collects at the end of the frame, when requested or once it's due and fits
+			// into what all of its contexts left of the budget
+			Memory->AddScriptTime(FPlatformTime::Seconds() - StartTime);
 		}
 
 		return true;
@@ -2527,7 +3082,10 @@ public:
 
 	void RequestV8GarbageCollection()
 	{
-		bGCRequested = true;
+		if (auto Memory = FJavascriptRuntimeMemory::Find(Runtime))
+		{
+			Memory->RequestCollection();
+		}
 	}
 
 	JsValueRef RunScriptInternal(JsValueRef Script, const FString& Path, bool bNewModule)
@@ -2583,6 +3141,77 @@ public:
 	}
 
 	// Should be guarded with proper handle scope
+	static bool LoadSerializedModuleSource(JsSourceContext SourceContext, JsValueRef* Value, JsParseScriptAttributes* ParseAttributes)
+	{
+		JsContextRef context = JS_INVALID_REFERENCE;
+		FJavascriptContextImplementation* Self = nullptr;
+		if (JsGetCurrentContext(&context) != JsNoError || context == JS_INVALID_REFERENCE ||
+			JsGetContextData(context, reinterpret_cast<void**>(&Self)) != JsNoError || Self == nullptr)
+		{
+			return false;
+		}
+
+		FString Source;
+		if (!Self->SerializedModuleSources.RemoveAndCopyValue(SourceContext, Source))
+		{
+			return false;
+		}
+
+		// chakra keeps the source value from here on
+		*Value = chakra::String(Source);
+		*ParseAttributes = JsParseScriptAttributeNone;
+		return true;
+	}
+
+	// Compiles a wrapped module, skipping the parser when a serialized copy is cached on disk
+	JsValueRef RunModuleScript(const FString& Script, const FString& Path)
+	{
+		// debuggers need the real source and parse events
+		if (!FJavascriptModuleCache::IsEnabled() || IsDebugContext() || inspector)
+		{
+			return RunScriptInternal(chakra::String(Script), Path, true);
+		}
+
+		JsValueRef Buffer = FJavascriptModuleCache::Load(Script);
+		if (!chakra::IsEmpty(Buffer))
+		{
+			// a reloaded module replaces the source kept for its previous load
+			JsSourceContext SourceContext = NextModuleSourceContext++;
+			if (const JsSourceContext* Previous = SerializedModuleSourceContexts.Find(Path))
+			{
+				SerializedModuleSources.Remove(*Previous);
+			}
+			SerializedModuleSources.Add(SourceContext, Script);
+			SerializedModuleSourceContexts.Add(Path, SourceContext);
+
+			JsValueRef returnValue = JS_INVALID_REFERENCE;
+			JsErrorCode err = JsRunSerialized(Buffer, &LoadSerializedModuleSource, SourceContext, chakra::String(LocalPathToURL(Path)), &returnValue);
+			if (err == JsNoError)
+			{
+				return returnValue;
+			}
+
+			// stale or corrupted entry; rebuild it below
+			UE_LOG(Javascript, Log, TEXT("Discarding module cache for %s (0x%08x)"), *Path, err);
+			SerializedModuleSources.Remove(SourceContext);
+			SerializedModuleSourceContexts.Remove(Path);
+
+			bool bHasException = false;
+			if (JsHasException(&bHasException) == JsNoError && bHasException)
+			{
+				JsValueRef exception = JS_INVALID_REFERENCE;
+				JsGetAndClearException(&exception);
+			}
+		}
+
+		JsValueRef Result = RunScriptInternal(chakra::String(Script), Path, true);
+		if (!chakra::IsEmpty(Result))
+		{
+			FJavascriptModuleCache::Save(Script);
+		}
+		return Result;
+	}
+
 	JsValueRef RunScript(const FString& Filename, const FString& Script)
 	{
 		FContextScope context_scope(context());
@@ -2650,6 +3279,8 @@ public:
 
 		TokenWriter w;
 
+		ExportAllTypes();
+
 		int DefaultValueId = 0;
 		JsValueRef Packer = RunScript(TEXT(""), TEXT("JSON.stringify"));
 
@@ -2747,7 +3378,7 @@ public:
 			}
 
 			TArray<UFunction*> Functions;
-			BlueprintFunctionLibraryMapping.MultiFind(ClassToExport, Functions);
+			GetLibraryMapping().Functions.MultiFind(ClassToExport, Functions);
 
 			auto conditional_emit_alias = [&](UFunction* Function, bool is_thunk) {
 				auto Alias = FV8Config::GetAlias(Function);
@@ -2802,7 +3433,7 @@ public:
 			auto ClassName = FV8Config::Safeify(StructToExport->GetName());
 
 			TArray<UFunction*> Functions;
-			BlueprintFunctionLibraryMapping.MultiFind(StructToExport, Functions);
+			GetLibraryMapping().Functions.MultiFind(StructToExport, Functions);
 
 			auto conditional_emit_alias = [&](UFunction* Function) {
 				auto Alias = FV8Config::GetAlias(Function);
@@ -2838,6 +3469,9 @@ public:
 	bool WriteDTS(const FString& Filename, bool bIncludingTooltip)
 	{
 #if WITH_EDITOR
+		// Typings cover every type, not only the ones touched so far
+		ExportAllTypes();
+
 		TypingGenerator instance(*this);
 
 		instance.no_tooltip = !bIncludingTooltip;
@@ -2865,29 +3499,107 @@ public:
 #endif
 	}
 
-	JsValueRef GetProxyFunction(UObject* Object, const TCHAR* Name)
+	JsValueRef GetProxyFunction(UObject* Object, const TCHAR* Name)
+	{
+		JsValueRef v8_obj = ExportObject(Object);
+		JsValueRef proxy = chakra::GetProperty(v8_obj, "proxy");
+		if (chakra::IsEmpty(proxy) || !chakra::IsObject(proxy))
+		{
+			return chakra::Undefined();
+		}
+
+		JsValueRef func = chakra::GetProperty(proxy, Name);
+		if (chakra::IsEmpty(func) || !chakra::IsFunction(func))
+		{
+			return chakra::Undefined();
+		}
+
+		return func;
+	}
+
+	// Holders are class templates (proxy classes) or object wrappers (eg. UMG elements)
+	static UObject* ProxyHolderFromChakra(JsValueRef Holder)
+	{
+		return chakra::IsFunction(Holder) ? chakra::UClassFromChakra(Holder) : chakra::UObjectFromChakra(Holder);
+	}
+
+	// Turns 'proxy' on Holder into an accessor over ProxyFunctionCache, keeping its current value
+	void TrackProxy(UObject* Object, JsValueRef Holder)
+	{
+		if (ProxyGetter.IsEmpty())
+		{
+			ProxyGetter.Reset(chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+				auto Self = reinterpret_cast<FJavascriptContextImplementation*>(callbackState);
+				UObject* Holder = ProxyHolderFromChakra(arguments[0]);
+				const TSharedPtr<FProxyFunctionCache>* Cache = Holder ? Self->ProxyFunctionCache.Find(Holder) : nullptr;
+				return Cache ? (*Cache)->Proxy.Get() : chakra::Undefined();
+			}, this));
+
+			ProxySetter.Reset(chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+				auto Self = reinterpret_cast<FJavascriptContextImplementation*>(callbackState);
+				if (UObject* Holder = ProxyHolderFromChakra(arguments[0]))
+				{
+					// start over whenever script assigns a new proxy object
+					Self->ProxyFunctionCache.Add(Holder, MakeShared<FProxyFunctionCache>(argumentCount > 1 ? arguments[1] : chakra::Undefined()));
+				}
+				return chakra::Undefined();
+			}, this));
+		}
+
+		ProxyFunctionCache.Add(Object, MakeShared<FProxyFunctionCache>(chakra::GetProperty(Holder, "proxy")));
+
+		JsValueRef AccessorDesc = JS_INVALID_REFERENCE;
+		JsCheck(JsCreateObject(&AccessorDesc));
+		chakra::SetProperty(AccessorDesc, "get", ProxyGetter.Get());
+		chakra::SetProperty(AccessorDesc, "set", ProxySetter.Get());
+		chakra::SetProperty(AccessorDesc, "configurable", chakra::Boolean(true));
+		chakra::SetProperty(AccessorDesc, "enumerable", chakra::Boolean(true));
+
+		bool ret = false;
+		JsCheck(JsDefineProperty(Holder, chakra::PropertyID("proxy"), AccessorDesc, &ret));
+	}
+
+	JsValueRef GetProxyFunction(UObject* Object, UFunction* Function)
 	{
-		JsValueRef v8_obj = ExportObject(Object);
-		JsValueRef proxy = chakra::GetProperty(v8_obj, "proxy");
+		// the cache is checked first; exporting and reading 'proxy' only happens once per holder
+		const TSharedPtr<FProxyFunctionCache>* Found = ProxyFunctionCache.Find(Object);
+		if (Found == nullptr)
+		{
+			JsValueRef v8_obj = ExportObject(Object);
+			if (!chakra::IsObject(v8_obj) && !chakra::IsFunction(v8_obj))
+			{
+				return chakra::Undefined();
+			}
+
+			TrackProxy(Object, v8_obj);
+			Found = ProxyFunctionCache.Find(Object);
+		}
+
+		// script may assign a new proxy while the lookup below runs
+		TSharedPtr<FProxyFunctionCache> Cache = *Found;
+		JsValueRef proxy = Cache->Proxy.Get();
 		if (chakra::IsEmpty(proxy) || !chakra::IsObject(proxy))
 		{
 			return chakra::Undefined();
 		}
 
-		JsValueRef func = chakra::GetProperty(proxy, Name);
+		FProxyFunctionCache::FEntry* Entry = Cache->Functions.Find(Function);
+		if (Entry && Entry->Name == Function->GetFName())
+		{
+			return Entry->Function.Get();
+		}
+
+		JsValueRef func = chakra::GetProperty(proxy, FV8Config::Safeify(Function->GetName()));
 		if (chakra::IsEmpty(func) || !chakra::IsFunction(func))
 		{
-			return chakra::Undefined();
+			// remember misses too; most ProcessEvent overrides ask for events the proxy doesn't handle
+			func = chakra::Undefined();
 		}
 
+		Cache->Functions.Emplace(Function, FProxyFunctionCache::FEntry(Function->GetFName(), func));
 		return func;
 	}
 
-	JsValueRef GetProxyFunction(UObject* Object, UFunction* Function)
-	{
-		return GetProxyFunction(Object, *FV8Config::Safeify(Function->GetName()));
-	}
-
 	bool HasProxyFunction(UObject* Holder, UFunction* Function)
 	{
 		FContextScope scope(context());
@@ -2902,6 +3614,9 @@ public:
 
 		if (!RunInGameThread && IsInGameThread()) return false;
 
+		FJavascriptBoundaryScope BoundaryScope(EJavascriptBoundary::ProxyCall, FunctionToCall);
+		FJavascriptTraceScope TraceScope(TEXT("ProcessEvent"), FunctionToCall);
+
 		FContextScope context_scope(context());
 
 		JsValueRef func = GetProxyFunction(Holder, FunctionToCall);
@@ -2910,7 +3625,11 @@ public:
 			JsValueRef global = JS_INVALID_REFERENCE;
 			JsCheck(JsGetGlobalObject(&global));
 
-			CallJavascriptFunction(context(), This ? ExportObject(This) : global, FunctionToCall, func, Parms);
+			JsValueRef self = This ? ExportObject(This) : global;
+
+			BoundaryScope.BeginInner();
+			CallJavascriptFunction(context(), self, FunctionToCall, func, Parms);
+			BoundaryScope.EndInner();
 
 			return true;
 		}
@@ -2948,6 +3667,34 @@ public:
 		return InternalReadProperty(Property, Buffer, Owner);
 	}
 
+	JsValueRef ReadProperty(const FPropertyAccessor& Accessor, uint8* Buffer, const IPropertyOwner& Owner)
+	{
+		if (!Buffer)
+		{
+			chakra::Throw(TEXT("Read property from invalid memory"));
+			return chakra::Undefined();
+		}
+
+		UProperty* Property = Accessor.Property;
+		switch (Accessor.Kind)
+		{
+		case EPropertyAccessorKind::Bool: return ConvertValue<bool>(*Property->ContainerPtrToValuePtr<bool>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Numeric: return ConvertValue<FNumericDummy>(*Property->ContainerPtrToValuePtr<FNumericDummy>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Name: return ConvertValue<FName>(*Property->ContainerPtrToValuePtr<FName>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::String: return ConvertValue<FString>(*Property->ContainerPtrToValuePtr<FString>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Text: return ConvertValue<FText>(*Property->ContainerPtrToValuePtr<FText>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Class: return ConvertValue<UClass*>(*Property->ContainerPtrToValuePtr<UClass*>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Struct: return ConvertValue<FStructDummy>(*Property->ContainerPtrToValuePtr<FStructDummy>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Array: return ConvertValue<FScriptArray>(*Property->ContainerPtrToValuePtr<FScriptArray>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::SoftObject: return ConvertValue<FSoftObjectPtr>(*Property->ContainerPtrToValuePtr<FSoftObjectPtr>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Object: return ConvertValue<UObject*>(*Property->ContainerPtrToValuePtr<UObject*>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Byte: return ConvertValue<uint8>(*Property->ContainerPtrToValuePtr<uint8>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Set: return ConvertValue<FScriptSet>(*Property->ContainerPtrToValuePtr<FScriptSet>(Buffer), Property, Owner);
+		case EPropertyAccessorKind::Map: return ConvertValue<FScriptMap>(*Property->ContainerPtrToValuePtr<FScriptMap>(Buffer), Property, Owner);
+		default: return InternalReadProperty(Property, Buffer, Owner);
+		}
+	}
+
 	template <typename T>
 	//JsValueRef ConvertValue(const T& cValue, UProperty* Property, const IPropertyOwner& Owner) = delete;
 	JsValueRef ConvertValue(const T& cValue, UProperty* Property, const IPropertyOwner& Owner)
@@ -2965,8 +3712,15 @@ public:
 			return ConvertValue<T>(*ptr, Property, Owner);
 		}
 
+		// fixed size numeric arrays are typed arrays, aliasing struct memory (see CreateTypedArrayView)
+		JsTypedArrayType ArrayType;
+		if (GetTypedArrayType(Property, ArrayType))
+		{
+			return CreateTypedArrayView(ArrayType, Property->ContainerPtrToValuePtr<uint8>(Buffer), Property->ArrayDim, Property->ElementSize, Owner);
+		}
+
 		JsValueRef array = JS_INVALID_REFERENCE;
-		JsCheck(JsCreateArray(0, &array));
+		JsCheck(JsCreateArray(Property->ArrayDim, &array));
 		for (int i = 0; i < Property->ArrayDim; i++)
 		{
 			T* ptr = Property->ContainerPtrToValuePtr<T>(Buffer, i);
@@ -2974,17 +3728,127 @@ public:
 		}
 
 		// sealing process
-		JsValueRef sealer = RunScript("", "arr => Object.seal(arr)");
-		check(chakra::IsFunction(sealer));
+		if (ArraySealer.IsEmpty())
+		{
+			JsValueRef global = JS_INVALID_REFERENCE;
+			JsCheck(JsGetGlobalObject(&global));
+			ArraySealer.Reset(chakra::GetProperty(chakra::GetProperty(global, "Object"), "seal"));
+		}
+		check(chakra::IsFunction(ArraySealer.Get()));
 
 		JsValueRef sealedArray = JS_INVALID_REFERENCE;
 		JsValueRef args[] = { chakra::Undefined(), array };
-		JsCheck(JsCallFunction(sealer, args, 2, &sealedArray));
+		JsCheck(JsCallFunction(ArraySealer.Get(), args, 2, &sealedArray));
 		check(chakra::IsArray(sealedArray));
 
 		return sealedArray;
 	}
 
+	static bool IsUnsignedProperty(UNumericProperty* Property)
+	{
+		return Property->IsA<UByteProperty>() || Property->IsA<UUInt16Property>() || Property->IsA<UUInt32Property>() || Property->IsA<UUInt64Property>();
+	}
+
+	// Typed array matching the memory layout of a numeric property, false for anything else
+	static bool GetTypedArrayType(UProperty* Property, JsTypedArrayType& OutType)
+	{
+		if (Property->IsA<UFloatProperty>()) OutType = JsArrayTypeFloat32;
+		else if (Property->IsA<UDoubleProperty>()) OutType = JsArrayTypeFloat64;
+		else if (Property->IsA<UIntProperty>()) OutType = JsArrayTypeInt32;
+		else if (Property->IsA<UUInt32Property>()) OutType = JsArrayTypeUint32;
+		else if (Property->IsA<UInt16Property>()) OutType = JsArrayTypeInt16;
+		else if (Property->IsA<UUInt16Property>()) OutType = JsArrayTypeUint16;
+		else if (Property->IsA<UInt8Property>()) OutType = JsArrayTypeInt8;
+		else if (auto p = Cast<UByteProperty>(Property))
+		{
+			// enums are read as names
+			if (p->Enum) return false;
+			OutType = JsArrayTypeUint8;
+		}
+		else return false;
+
+		return true;
+	}
+
+	static void CHAKRA_CALLBACK FinalizeExternalArray(void* Data)
+	{
+		// buffers may outlive their context in a shared runtime, the struct memory stays allocated until then
+		auto Owner = reinterpret_cast<FExternalArrayOwner*>(Data);
+		Owner->Memory->NumExternalViews--;
+		delete Owner;
+	}
+
+	// Typed array over Num elements at Data. Memory of an independent struct instance is aliased and keeps the instance
+	// alive; anything else is copied: objects can be destroyed under a view, parameters and temporaries go away.
+	// Only storage which never moves may be aliased.
+	JsValueRef CreateTypedArrayView(JsTypedArrayType ArrayType, uint8* Data, int32 Num, int32 ElementSize, const IPropertyOwner& Owner)
+	{
+		JsValueRef view = JS_INVALID_REFERENCE;
+
+		// the instance which owns the storage, nested instances point into their parent's
+		TSharedPtr<FStructMemoryInstance> Storage;
+		if (Num > 0 && Owner.Owner == EPropertyOwner::Memory)
+		{
+			auto Memory = ((const FStructMemoryPropertyOwner&)Owner).Memory;
+			Storage = Memory->Parent.IsValid() ? Memory->Parent : Memory->AsShared();
+			if (Storage->Owner != EPropertyOwner::None)
+			{
+				Storage.Reset();
+			}
+		}
+
+		if (Storage.IsValid())
+		{
+			auto ArrayOwner = new FExternalArrayOwner;
+			ArrayOwner->Memory = Storage;
+			Storage->NumExternalViews++;
+
+			JsValueRef buffer = JS_INVALID_REFERENCE;
+			JsCheck(JsCreateExternalArrayBuffer(Data, Num * ElementSize, FinalizeExternalArray, ArrayOwner, &buffer));
+			JsCheck(JsCreateTypedArray(ArrayType, buffer, 0, Num, &view));
+		}
+		else
+		{
+			JsCheck(JsCreateTypedArray(ArrayType, JS_INVALID_REFERENCE, 0, Num, &view));
+			if (Num > 0)
+			{
+				ChakraBytePtr Bytes = nullptr;
+				unsigned int Length = 0;
+				JsCheck(JsGetTypedArrayStorage(view, &Bytes, &Length, nullptr, nullptr));
+				FMemory::Memcpy(Bytes, Data, Length);
+			}
+		}
+
+		return view;
+	}
+
+	// Copies a typed array of the same element type into Data, false if the types differ
+	static bool CopyFromTypedArray(UProperty* Property, uint8* Data, int32 Num, JsValueRef Value)
+	{
+		JsTypedArrayType ArrayType;
+		if (!GetTypedArrayType(Property, ArrayType) || !chakra::IsTypedArray(Value))
+		{
+			return false;
+		}
+
+		ChakraBytePtr Storage = nullptr;
+		unsigned int Length = 0;
+		JsTypedArrayType SourceType;
+		JsCheck(JsGetTypedArrayStorage(Value, &Storage, &Length, &SourceType, nullptr));
+		if (SourceType != ArrayType)
+		{
+			return false;
+		}
+
+		// writing a view back onto its own memory
+		if (Storage != Data)
+		{
+			FMemory::Memmove(Data, Storage, FMath::Min<int32>(Length, Num * Property->ElementSize));
+		}
+
+		return true;
+	}
+
 	JsValueRef InternalReadProperty(UProperty* Property, uint8* Buffer, const IPropertyOwner& Owner)
 	{
 		if (!Buffer)
@@ -2995,17 +3859,7 @@ public:
 
 		if (Property->IsA<UNumericProperty>() && !Property->IsA<UByteProperty>())
 		{
-			auto p = Cast<UNumericProperty>(Property);
-
-			if (p->IsFloatingPoint())
-				return InternalReadSealedArray<float>(p, Buffer, Owner);
-
-			check(p->IsInteger());
-
-			if (p->IsA<UByteProperty>() || p->IsA<UUInt16Property>() || p->IsA<UUInt32Property>() || p->IsA<UUInt64Property>() || p->IsA<UUnsizedUIntProperty>())
-				return InternalReadSealedArray<uint32>(p, Buffer, Owner);
-
-			return InternalReadSealedArray<int32>(p, Buffer, Owner);
+			return InternalReadSealedArray<FNumericDummy>(Property, Buffer, Owner);
 		}
 		else if (auto p = Cast<UBoolProperty>(Property))
 		{
@@ -3070,6 +3924,10 @@ public:
 		SCOPE_CYCLE_COUNTER(STAT_JavascriptReadOffStruct);
 		FScopeCycleCounterUObject StructContext(Struct);
 
+		// core math structs don't need reflection
+		if (FJavascriptMathStructs::Read(v8_obj, Cast<UScriptStruct>(Struct), struct_buffer))
+			return;
+
 		JsValueRef arr = JS_INVALID_REFERENCE;
 		JsCheck(JsGetOwnPropertyNames(v8_obj, &arr));
 		if (chakra::IsEmpty(arr)) return;
@@ -3079,9 +3937,8 @@ public:
 		for (TFieldIterator<UProperty> PropertyIt(Struct, EFieldIteratorFlags::IncludeSuper); PropertyIt && len; ++PropertyIt)
 		{
 			UProperty* Property = *PropertyIt;
-			FString PropertyName = PropertyNameToString(Property);
 
-			JsValueRef value = chakra::GetProperty(v8_obj, PropertyName);
+			JsValueRef value = chakra::GetProperty(v8_obj, Property);
 
 			if (!chakra::IsEmpty(value) && !chakra::IsUndefined(value))
 			{
@@ -3096,6 +3953,36 @@ public:
 		InternalWriteProperty(Property, Buffer, Value);
 	}
 
+	void WriteProperty(const FPropertyAccessor& Accessor, uint8* Buffer, JsValueRef Value)
+	{
+		if (!Buffer)
+		{
+			chakra::Throw(TEXT("Write property on invalid memory"));
+			return;
+		}
+
+		if (chakra::IsEmpty(Value) || chakra::IsUndefined(Value)) return;
+
+		UProperty* Property = Accessor.Property;
+		switch (Accessor.Kind)
+		{
+		case EPropertyAccessorKind::Bool: return FromValue<bool>(Property->ContainerPtrToValuePtr<bool>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Numeric: return FromValue<FNumericDummy>(Property->ContainerPtrToValuePtr<FNumericDummy>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Name: return FromValue<FName>(Property->ContainerPtrToValuePtr<FName>(Buffer), Property, Value);
+		case EPropertyAccessorKind::String: return FromValue<FString>(Property->ContainerPtrToValuePtr<FString>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Text: return FromValue<FText>(Property->ContainerPtrToValuePtr<FText>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Class: return FromValue<UClass*>(Property->ContainerPtrToValuePtr<UClass*>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Struct: return FromValue<FStructDummy>(Property->ContainerPtrToValuePtr<FStructDummy>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Array: return FromValue<FScriptArray>(Property->ContainerPtrToValuePtr<FScriptArray>(Buffer), Property, Value);
+		case EPropertyAccessorKind::SoftObject: return FromValue<FSoftObjectPtr>(Property->ContainerPtrToValuePtr<FSoftObjectPtr>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Object: return FromValue<UObject*>(Property->ContainerPtrToValuePtr<UObject*>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Byte: return FromValue<uint8>(Property->ContainerPtrToValuePtr<uint8>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Set: return FromValue<FScriptSet>(Property->ContainerPtrToValuePtr<FScriptSet>(Buffer), Property, Value);
+		case EPropertyAccessorKind::Map: return FromValue<FScriptMap>(Property->ContainerPtrToValuePtr<FScriptMap>(Buffer), Property, Value);
+		default: return InternalWriteProperty(Property, Buffer, Value);
+		}
+	}
+
 	template <typename T>
 	//void FromValue(T* Ptr, UProperty* Property, JsValueRef Value) = delete;
 	void FromValue(T* Ptr, UProperty* Property, JsValueRef Value)
@@ -3107,7 +3994,22 @@ public:
 	template <typename T>
 	void InternalWriteSealedArray(UProperty* Property, uint8* Buffer, JsValueRef Value)
 	{
-		if (chakra::IsArray(Value) && Property->ArrayDim > 1)
+		if (Property->ArrayDim > 1 && chakra::IsTypedArray(Value))
+		{
+			if (chakra::Length(Value) != Property->ArrayDim)
+			{
+				chakra::Throw(TEXT("Length mismatch for fixed size array"));
+			}
+			else if (!CopyFromTypedArray(Property, Property->ContainerPtrToValuePtr<uint8>(Buffer), Property->ArrayDim, Value))
+			{
+				for (int i = 0; i < Property->ArrayDim; i++)
+				{
+					T* ptr = Property->ContainerPtrToValuePtr<T>(Buffer, i);
+					FromValue<T>(ptr, Property, chakra::GetIndex(Value, i));
+				}
+			}
+		}
+		else if (chakra::IsArray(Value) && Property->ArrayDim > 1)
 		{
 			check(chakra::Length(Value) == Property->ArrayDim); // this is fixed size array
 			for (int i = 0; i < Property->ArrayDim; i++)
@@ -3138,18 +4040,7 @@ public:
 
 		if (Property->IsA<UNumericProperty>() && !Property->IsA<UByteProperty>())
 		{
-			auto p = Cast<UNumericProperty>(Property);
-			uint8* ptr = p->ContainerPtrToValuePtr<uint8>(Buffer);
-
-			if (p->IsFloatingPoint())
-				return InternalWriteSealedArray<float>(Property, Buffer, Value);
-
-			check(p->IsInteger());
-
-			if (p->IsA<UUInt16Property>() || p->IsA<UUInt32Property>() || p->IsA<UUInt64Property>() || p->IsA<UUnsizedUIntProperty>())
-				return InternalWriteSealedArray<uint32>(Property, Buffer, Value);
-
-			return InternalWriteSealedArray<int32>(Property, Buffer, Value);
+			return InternalWriteSealedArray<FNumericDummy>(Property, Buffer, Value);
 		}
 		else if (auto p = Cast<UBoolProperty>(Property))
 		{
@@ -3519,56 +4410,61 @@ public:
 		chakra::SetProperty(global_templ, "memory", chakra::New(Template));
 	}
 
+	TSharedRef<const FFunctionCallPlan> GetFunctionCallPlan(UFunction* Function)
+	{
+		return Bindings.GetFunctionCallPlan(Function);
+	}
+
 	template <typename Fn>
 	JsValueRef CallFunction(JsValueRef self, UFunction* Function, UObject* Object, Fn&& GetArg)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_JavascriptFunctionCallToEngine);
+		FJavascriptBoundaryScope BoundaryScope(EJavascriptBoundary::CallToEngine, Function);
+
+		// held until the call returns, recompiling or reloading during ProcessEvent invalidates the cached plan
+		const TSharedRef<const FFunctionCallPlan> PlanRef = GetFunctionCallPlan(Function);
+		const FFunctionCallPlan& Plan = *PlanRef;
 
 		// Allocate buffer(param size) in stack
 		uint8* Buffer = (uint8*)FMemory_Alloca(Function->ParmsSize);
 
 		// Arguments should construct and destruct along this scope
-		FScopedArguments scoped_arguments(Function, Buffer);
-
-		// Does this function return some parameters by reference?
-		bool bHasAnyOutParams = false;
-
-		// Argument index
-		int ArgIndex = 0;
+		FMemory::Memzero(Buffer, Function->ParmsSize);
+		for (UProperty* Param : Plan.ParamsToInitialize)
+		{
+			Param->InitializeValue_InContainer(Buffer);
+		}
 
-		// Intentionally declares iterator outside for-loop scope
-		TFieldIterator<UProperty> It(Function);
+		ON_SCOPE_EXIT
+		{
+			for (UProperty* Param : Plan.ParamsToDestroy)
+			{
+				Param->DestroyValue_InContainer(Buffer);
+			}
+		};
 
-		int32 NumArgs = 0;
+		const int32 NumArgs = Plan.InParams.Num();
 
 		// Iterate over input parameters
-		for (; It && (It->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm; ++It)
+		for (int32 ArgIndex = 0; ArgIndex < NumArgs; ++ArgIndex)
 		{
-			UProperty* Prop = *It;
-
 			// Get argument from caller
-			JsValueRef arg = GetArg(ArgIndex++);
+			JsValueRef arg = GetArg(ArgIndex);
 
 			// Do we have valid argument?
 			if (!chakra::IsEmpty(arg) && !chakra::IsUndefined(arg))
 			{
-				WriteProperty(Prop, Buffer, arg);
-			}
-
-			// This is 'out ref'!
-			if ((It->PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
-			{
-				bHasAnyOutParams = true;
+				WriteProperty(Plan.InParams[ArgIndex], Buffer, arg);
 			}
 		}
 
-		NumArgs = ArgIndex;
-
 		// Call regular native function.
 		FScopeCycleCounterUObject ContextScope(Object);
 		FScopeCycleCounterUObject FunctionScope(Function);
 
+		BoundaryScope.BeginInner();
 		Object->ProcessEvent(Function, Buffer);
+		BoundaryScope.EndInner();
 
 		auto FetchProperty = [&](UProperty* Param, int32 ArgIndex) {
 			if (auto p = Cast<UStructProperty>(Param))
@@ -3593,56 +4489,38 @@ public:
 		};
 
 		// In case of 'out ref'
-		if (bHasAnyOutParams)
+		if (Plan.OutParams.Num())
 		{
-			ArgIndex = 0;
-
 			// Allocate an object to pass return values within
 			JsValueRef OutParameters = JS_INVALID_REFERENCE;
 			JsCheck(JsCreateObject(&OutParameters));
 
-			// Iterate over parameters again
-			for (TFieldIterator<UProperty> It(Function); It; ++It, ArgIndex++)
+			for (const auto& Out : Plan.OutParams)
 			{
-				UProperty* Param = *It;
-
-				auto PropertyFlags = Param->GetPropertyFlags();
-
-				// pass return parameter as '$'
-				if (PropertyFlags & CPF_ReturnParm)
+				JsValueRef value = FetchProperty(Out.Property, Out.ArgIndex);
+				if (!chakra::IsEmpty(value))
 				{
-					// value can be null if isolate is in trouble
-					JsValueRef value = FetchProperty(Param, NumArgs);
-					if (!chakra::IsEmpty(value))
-					{
-						chakra::SetProperty(OutParameters, "$", value);
-					}
+					JsCheck(JsSetProperty(OutParameters, Out.Id, value, true));
 				}
-				// rejects 'const T&' and pass 'T&' as its name
-				else if ((PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
+			}
+
+			// pass return parameter as '$'
+			if (Plan.ReturnParam)
+			{
+				// value can be null if isolate is in trouble
+				JsValueRef value = FetchProperty(Plan.ReturnParam, NumArgs);
+				if (!chakra::IsEmpty(value))
 				{
-					JsValueRef value = FetchProperty(Param, ArgIndex);
-					if (!chakra::IsEmpty(value))
-					{
-						chakra::SetProperty(OutParameters, Param->GetName(), value);
-					}
+					JsCheck(JsSetProperty(OutParameters, Plan.ReturnId, value, true));
 				}
 			}
 
 			// We're done
 			return OutParameters;
 		}
-		else
+		else if (Plan.ReturnParam)
 		{
-			// Iterate to fill out return parameter (if we have one)
-			for (; It; ++It)
-			{
-				UProperty* Param = *It;
-				if (Param->GetPropertyFlags() & CPF_ReturnParm)
-				{
-					return FetchProperty(Param, NumArgs);
-				}
-			}
+			return FetchProperty(Plan.ReturnParam, NumArgs);
 		}
 
 		// No return value available
@@ -3672,7 +4550,7 @@ public:
 			UObject* Object = (Function->FunctionFlags & FUNC_Static) ? Function->GetOwnerClass()->ClassDefaultObject : chakra::UObjectFromChakra(self);
 
 			// Check 'this' is valid
-			if (!Object->IsValidLowLevelFast())
+			if (!Object)
 			{
 				chakra::Throw(FString::Printf(TEXT("Invalid instance for calling a function %s"), *Function->GetName()));
 				return chakra::Undefined();
@@ -3794,52 +4672,54 @@ public:
 	}
 
 	template <typename PropertyAccessors>
-	void ExportProperty(JsValueRef Template, UProperty* PropertyToExport, int32 PropertyIndex)
+	void ExportProperty(JsValueRef Template, const FJavascriptTypeBinding::FPropertyBinding& Binding)
 	{
 		// Property getter
 		auto Getter = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
-			JsValueRef data = reinterpret_cast<JsValueRef>(callbackState);
-			UProperty* Property = nullptr;
-			JsCheck(JsGetExternalData(data, (void**)&Property));
+			const FPropertyAccessor* Accessor = reinterpret_cast<const FPropertyAccessor*>(callbackState);
 
 			FJavascriptContextImplementation* ctx = GetFrom(callee);
 			FContextScope(ctx->context());
-			return PropertyAccessors::Get(ctx, arguments[0], Property);
+			return PropertyAccessors::Get(ctx, arguments[0], *Accessor);
 		};
 
 		// Property setter
 		auto Setter = [](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
-			JsValueRef data = reinterpret_cast<JsValueRef>(callbackState);
-			UProperty* Property = nullptr;
-			JsCheck(JsGetExternalData(data, (void**)&Property));
+			const FPropertyAccessor* Accessor = reinterpret_cast<const FPropertyAccessor*>(callbackState);
 
 			FJavascriptContextImplementation* ctx = GetFrom(callee);
 			FContextScope(ctx->context());
-			PropertyAccessors::Set(ctx, arguments[0], Property, arguments[1]);
+			PropertyAccessors::Set(ctx, arguments[0], *Accessor, arguments[1]);
 			return arguments[1];
 		};
 
+		// accessors are shared by all contexts of the runtime, each keeps the ones its functions point at
+		ExportedAccessors.Add(Binding.Accessor);
+		void* Accessor = const_cast<FPropertyAccessor*>(&Binding.Accessor.Get());
+
 		chakra::FPropertyDescriptor desc;
-		desc.Getter = chakra::FunctionTemplate(Getter, chakra::External(PropertyToExport, nullptr));
-		desc.Setter = chakra::FunctionTemplate(Setter, chakra::External(PropertyToExport, nullptr));
+		desc.Getter = chakra::FunctionTemplate(Getter, Accessor);
+		desc.Setter = chakra::FunctionTemplate(Setter, Accessor);
 		desc.Configurable = false; // don't delete
-		desc.Writable = !FV8Config::IsWriteDisabledProperty(PropertyToExport);
+		desc.Writable = Binding.bWritable;
 
-		chakra::SetAccessor(Template, PropertyNameToString(PropertyToExport), desc);
+		chakra::SetAccessor(Template, Binding.Name, desc);
 	}
 
 	void ExportHelperFunctions(UStruct* ClassToExport, JsValueRef Template)
 	{
+		const FJavascriptLibraryMapping& Mapping = GetLibraryMapping();
+
 		// Bind blue print library!
 		TArray<UFunction*> Functions;
-		BlueprintFunctionLibraryMapping.MultiFind(ClassToExport, Functions);
+		Mapping.Functions.MultiFind(ClassToExport, Functions);
 
 		for (auto Function : Functions)
 		{
 			ExportBlueprintLibraryFunction(Template, Function);
 		}
 
-		BlueprintFunctionLibraryFactoryMapping.MultiFind(ClassToExport, Functions);
+		Mapping.Factories.MultiFind(ClassToExport, Functions);
 		for (auto Function : Functions)
 		{
 			ExportBlueprintLibraryFactoryFunction(Template, Function);
@@ -4114,8 +4994,7 @@ public:
 				if (!FV8Config::CanExportProperty(Class, Property))
 					continue;
 
-				FString name = PropertyNameToString(Property);
-				JsValueRef value = PropertyAccessor::Get(GetFrom(callee), self, Property);
+				JsValueRef value = PropertyAccessor::Get(GetFrom(callee), self, FPropertyAccessor(Property));
 				if (auto p = Cast<UClassProperty>(Property))
 				{
 					UClass* Class = chakra::UClassFromChakra(value);
@@ -4138,11 +5017,11 @@ public:
 						value = chakra::String("null");
 					}
 
-					chakra::SetProperty(out, name, value);
+					chakra::SetProperty(out, Property, value);
 				}
 				else
 				{
-					chakra::SetProperty(out, name, value);
+					chakra::SetProperty(out, Property, value);
 				}
 			}
 
@@ -4372,23 +5251,15 @@ public:
 		chakra::SetProperty(templateProto, static_class, chakra::External(ClassToExport, nullptr));
 		chakra::SetProperty(Template, static_class, chakra::External(ClassToExport, nullptr));
 
-		for (TFieldIterator<UFunction> FuncIt(ClassToExport, EFieldIteratorFlags::ExcludeSuper); FuncIt; ++FuncIt)
+		const FJavascriptTypeBinding& Binding = Bindings.GetTypeBinding(ClassToExport);
+		for (UFunction* Function : Binding.Functions)
 		{
-			UFunction* Function = *FuncIt;
-			if (FV8Config::CanExportFunction(ClassToExport, Function))
-			{
-				ExportFunction(Template, Function);
-			}
+			ExportFunction(Template, Function);
 		}
 
-		int32 PropertyIndex = 0;
-		for (TFieldIterator<UProperty> PropertyIt(ClassToExport, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt, ++PropertyIndex)
+		for (const auto& Property : Binding.Properties)
 		{
-			UProperty* Property = *PropertyIt;
-			if (FV8Config::CanExportProperty(ClassToExport, Property))
-			{
-				ExportProperty<FObjectPropertyAccessors>(Template, Property, PropertyIndex);
-			}
+			ExportProperty<FObjectPropertyAccessors>(Template, Property);
 		}
 
 		return Template;
@@ -4404,24 +5275,22 @@ public:
 			{
 				JsValueRef self = arguments[0];
 
+				FJavascriptContextImplementation* Context = GetFrom(callee);
 				TSharedPtr<FStructMemoryInstance> Memory;
 
-				if (argumentCount == 3 && chakra::IsExternal(arguments[1]) && chakra::IsExternal(arguments[2]))
+				if (Context->PendingStructSource)
 				{
-					IPropertyOwner* Owner;
-					JsCheck(JsGetExternalData(arguments[2], reinterpret_cast<void**>(&Owner)));
-
-					void* Source;
-					JsCheck(JsGetExternalData(arguments[1], &Source));
-					Memory = FStructMemoryInstance::Create(StructToExport, *Owner, Source);
+					const FPendingStructSource Pending = *Context->PendingStructSource;
+					Context->PendingStructSource = nullptr;
+					Memory = FStructMemoryInstance::Create(StructToExport, *Pending.Owner, Pending.Buffer);
 				}
 				else
 				{
 					Memory = FStructMemoryInstance::Create(StructToExport, FNoPropertyOwner());
 				}
 
-				GetFrom(callee)->RegisterScriptStructInstance(Memory, self);
-				chakra::SetProperty(self, "__self", chakra::External(Memory.Get(), nullptr));
+				Context->RegisterScriptStructInstance(Memory, self);
+				chakra::SetNativeHandle(self, Memory.Get(), ENativeHandleType::Struct);
 
 				return chakra::Undefined();
 
@@ -4455,14 +5324,9 @@ public:
 		chakra::SetProperty(templateProto, static_class, chakra::External(StructToExport, nullptr));
 		chakra::SetProperty(Template, static_class, chakra::External(StructToExport, nullptr));
 
-		int32 PropertyIndex = 0;
-		for (TFieldIterator<UProperty> PropertyIt(StructToExport, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt, ++PropertyIndex)
+		for (const auto& Property : Bindings.GetTypeBinding(StructToExport).Properties)
 		{
-			UProperty* Property = *PropertyIt;
-			if (FV8Config::CanExportProperty(StructToExport, Property))
-			{
-				ExportProperty<FStructPropertyAccessors>(Template, Property, PropertyIndex);
-			}
+			ExportProperty<FStructPropertyAccessors>(Template, Property);
 		}
 
 		return Template;
@@ -4473,6 +5337,8 @@ public:
 		auto ExportedFunctionTemplatePtr = ScriptStructToFunctionTemplateMap.Find(ScriptStruct);
 		if (ExportedFunctionTemplatePtr == nullptr)
 		{
+			FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::TypeExport, ScriptStruct);
+
 			JsValueRef Template = InternalExportStruct(ScriptStruct);
 
 			UScriptStruct* SuperStruct = Cast<UScriptStruct>(ScriptStruct->GetSuperStruct());
@@ -4495,15 +5361,19 @@ public:
 
 	JsValueRef ExportEnum(UEnum* Enum)
 	{
+		FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::TypeExport, Enum);
+
 		int MaxEnumValue = Enum->GetMaxEnumValue();
 		JsValueRef arr = JS_INVALID_REFERENCE;
 		JsCheck(JsCreateArray(MaxEnumValue, &arr));
 
 		// public name
 		FString enumName = FV8Config::Safeify(Enum->GetName());
-		JsValueRef global = GetGlobalTemplate();
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
 
 		UE_LOG(Javascript, Verbose, TEXT("Global %p"), global);
+		chakra::SetProperty(global, enumName, arr);
 		chakra::SetProperty(GetGlobalTemplate(), enumName, arr);
 
 		for (decltype(MaxEnumValue) Index = 0; Index < MaxEnumValue; ++Index)
@@ -4522,6 +5392,8 @@ public:
 		auto ExportedFunctionTemplatePtr = ClassToFunctionTemplateMap.Find(Class);
 		if (ExportedFunctionTemplatePtr == nullptr)
 		{
+			FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::TypeExport, Class);
+
 			JsValueRef Template = InternalExportClass(Class);
 
 			UClass* SuperClass = Class->GetSuperClass();
@@ -4571,13 +5443,14 @@ public:
 			return chakra::Undefined();
 
 		JsValueRef v8_struct = ExportStruct(Struct);
-		JsValueRef args[] = {
-			chakra::Undefined(),
-			chakra::External(Buffer, nullptr),
-			chakra::External((void*)&Owner, nullptr)
-		};
 
-		JsValueRef obj = chakra::New(v8_struct, args, 3);
+		// picked up by the constructor, saves wrapping both pointers in external objects
+		FPendingStructSource Pending{ Buffer, &Owner };
+		PendingStructSource = &Pending;
+
+		JsValueRef obj = chakra::New(v8_struct);
+		PendingStructSource = nullptr;
+
 		if (chakra::IsEmpty(obj))
 			return chakra::Undefined();
 
@@ -4688,6 +5561,7 @@ public:
 	void RegisterObject(UObject* UnrealObject, JsValueRef value)
 	{
 		ObjectToObjectMap.Add(UnrealObject, value);
+		WrapperCensus.OnCreated(UnrealObject);
 
 		// track gc
 		JsCheck(JsSetObjectBeforeCollectCallback(value, UnrealObject, FinalizeUObject));
@@ -4695,7 +5569,10 @@ public:
 
 	void RegisterScriptStructInstance(TSharedPtr<FStructMemoryInstance> MemoryObject, JsValueRef value)
 	{
-		MemoryToObjectMap.Add(MemoryObject, value);
+		// the wrapper is not held, the instance goes back to the pool once it is collected
+		MemoryObject->ContextIndex = StructInstances.Add(MemoryObject);
+		StructInstanceTypes.FindOrAdd(MemoryObject->Struct)++;
+		WrapperCensus.OnCreated(MemoryObject.Get());
 
 		// track gc
 		JsCheck(JsSetObjectBeforeCollectCallback(value, MemoryObject.Get(), FinalizeScriptStruct));
@@ -4704,7 +5581,27 @@ public:
 	void OnGarbageCollectedByChakra(FStructMemoryInstance* Memory)
 	{
 		// We should keep ourselves clean
-		MemoryToObjectMap.Remove(Memory->AsShared());
+		const int32 Index = Memory->ContextIndex;
+		if (StructInstances.IsValidIndex(Index) && StructInstances[Index].Get() == Memory)
+		{
+			// orphans have been taken out of the type counts already
+			if (!Memory->bOrphaned)
+			{
+				RemoveStructInstanceType(Memory->Struct);
+			}
+
+			WrapperCensus.OnReleased(Memory);
+			StructInstances.RemoveAt(Index);
+		}
+	}
+
+	void RemoveStructInstanceType(UScriptStruct* Struct)
+	{
+		int32* Count = StructInstanceTypes.Find(Struct);
+		if (Count && --*Count <= 0)
+		{
+			StructInstanceTypes.Remove(Struct);
+		}
 	}
 
 	void OnGarbageCollectedByChakra(UObject* Object)
@@ -4717,7 +5614,46 @@ public:
 			ClassToFunctionTemplateMap.Remove(klass);
 		}
 
-		ObjectToObjectMap.Remove(Object);
+		if (ObjectToObjectMap.Remove(Object))
+		{
+			WrapperCensus.OnReleased(Object);
+		}
+		ProxyFunctionCache.Remove(Object);
+	}
+
+	void CollectWrapperCensus(FJavascriptWrapperCensus::FReport& Report)
+	{
+		for (const auto& Pair : ObjectToObjectMap)
+		{
+			UClass* Class = Pair.Key->GetClass();
+			WrapperCensus.Add(Report, Class->GetName(), false, Class->GetStructureSize(), Pair.Key);
+		}
+
+		for (const auto& Instance : StructInstances)
+		{
+			if (!Instance->bOrphaned)
+			{
+				WrapperCensus.Add(Report, Instance->Struct->GetName(), true, Instance->GetRetainedSize(), Instance.Get());
+			}
+		}
+	}
+
+	virtual FString GetWrapperCensus(bool bSinceSnapshot) override
+	{
+		FJavascriptWrapperCensus::FReport Report;
+		CollectWrapperCensus(Report);
+
+		FStringOutputDevice Output;
+		Output.SetAutoEmitLineTerminator(true);
+		WrapperCensus.Dump(Output, Report, bSinceSnapshot);
+		return MoveTemp(Output);
+	}
+
+	virtual void SnapshotWrappers() override
+	{
+		FJavascriptWrapperCensus::FReport Report;
+		CollectWrapperCensus(Report);
+		WrapperCensus.Snapshot(Report);
 	}
 
 	static FJavascriptContextImplementation* GetFrom(JsValueRef objInContext)
@@ -4748,21 +5684,23 @@ JsValueRef FJavascriptContextImplementation::ConvertValue<bool>(const bool& cVal
 }
 
 template <>
-JsValueRef FJavascriptContextImplementation::ConvertValue<int32>(const int32& cValue, UProperty* Property, const IPropertyOwner& Owner)
-{
-	return chakra::Int(cValue);
-}
-
-template <>
-JsValueRef FJavascriptContextImplementation::ConvertValue<uint32>(const uint32& cValue, UProperty* Property, const IPropertyOwner& Owner)
+JsValueRef FJavascriptContextImplementation::ConvertValue<FNumericDummy>(const FNumericDummy& cValue, UProperty* Property, const IPropertyOwner& Owner)
 {
-	return chakra::Int(cValue);
-}
+	UNumericProperty* NumericProperty = static_cast<UNumericProperty*>(Property);
+	const void* Data = &cValue;
 
-template <>
-JsValueRef FJavascriptContextImplementation::ConvertValue<float>(const float& cValue, UProperty* Property, const IPropertyOwner& Owner)
-{
-	return chakra::Double(cValue);
+	if (NumericProperty->IsFloatingPoint())
+	{
+		return chakra::Double(NumericProperty->GetFloatingPointPropertyValue(Data));
+	}
+	else if (IsUnsignedProperty(NumericProperty))
+	{
+		return chakra::UInt64(NumericProperty->GetUnsignedIntPropertyValue(Data));
+	}
+	else
+	{
+		return chakra::Int64(NumericProperty->GetSignedIntPropertyValue(Data));
+	}
 }
 
 template <>
@@ -4845,11 +5783,18 @@ JsValueRef FJavascriptContextImplementation::ConvertValue<FScriptArray>(const FS
 	FScriptArrayHelper helper(arrayProperty, reinterpret_cast<const void*>(&cValue));
 	auto len = (uint32_t)(helper.Num());
 
+	auto Inner = arrayProperty->Inner;
+
+	// numeric arrays are copied into typed arrays in one go, their storage moves when resized so it can't be aliased
+	JsTypedArrayType ArrayType;
+	if (GetTypedArrayType(Inner, ArrayType))
+	{
+		return CreateTypedArrayView(ArrayType, helper.GetRawPtr(), len, Inner->ElementSize, FNoPropertyOwner());
+	}
+
 	JsValueRef arr = JS_INVALID_REFERENCE;
 	JsCheck(JsCreateArray(len, &arr));
 
-	auto Inner = arrayProperty->Inner;
-
 	if (Inner->IsA(UStructProperty::StaticClass()))
 	{
 		uint8* ElementBuffer = (uint8*)FMemory_Alloca(Inner->GetSize());
@@ -4960,21 +5905,22 @@ void FJavascriptContextImplementation::FromValue<bool>(bool* Ptr, UProperty* Pro
 }
 
 template<>
-void FJavascriptContextImplementation::FromValue<int32>(int32* Ptr, UProperty* Property, JsValueRef Value)
-{
-	Cast<UNumericProperty>(Property)->SetIntPropertyValue(Ptr, (int64)chakra::IntFrom(Value));
-}
-
-template<>
-void FJavascriptContextImplementation::FromValue<uint32>(uint32* Ptr, UProperty* Property, JsValueRef Value)
+void FJavascriptContextImplementation::FromValue<FNumericDummy>(FNumericDummy* Ptr, UProperty* Property, JsValueRef Value)
 {
-	Cast<UNumericProperty>(Property)->SetIntPropertyValue(Ptr, (uint64)chakra::IntFrom(Value));
-}
+	UNumericProperty* NumericProperty = static_cast<UNumericProperty*>(Property);
 
-template<>
-void FJavascriptContextImplementation::FromValue<float>(float* Ptr, UProperty* Property, JsValueRef Value)
-{
-	Cast<UNumericProperty>(Property)->SetFloatingPointPropertyValue(Ptr, (double)chakra::DoubleFrom(Value));
+	if (NumericProperty->IsFloatingPoint())
+	{
+		NumericProperty->SetFloatingPointPropertyValue(Ptr, chakra::DoubleFrom(Value));
+	}
+	else if (IsUnsignedProperty(NumericProperty))
+	{
+		NumericProperty->SetIntPropertyValue(Ptr, chakra::UInt64From(Value));
+	}
+	else
+	{
+		NumericProperty->SetIntPropertyValue(Ptr, chakra::Int64From(Value));
+	}
 }
 
 template<>
@@ -5069,7 +6015,26 @@ void FJavascriptContextImplementation::FromValue<FScriptArray>(FScriptArray* Ptr
 	UArrayProperty* arrayProperty = Cast<UArrayProperty>(Property);
 	check(arrayProperty);
 
-	if (chakra::IsArray(Value))
+	if (chakra::IsTypedArray(Value))
+	{
+		FScriptArrayHelper helper(arrayProperty, Ptr);
+
+		int len = chakra::Length(Value);
+		int CurSize = helper.Num();
+		if (CurSize != len)
+		{
+			helper.Resize(len);
+		}
+
+		if (len > 0 && !CopyFromTypedArray(arrayProperty->Inner, helper.GetRawPtr(), len, Value))
+		{
+			for (decltype(len) Index = 0; Index < len; ++Index)
+			{
+				WriteProperty(arrayProperty->Inner, helper.GetRawPtr(Index), chakra::GetIndex(Value, Index));
+			}
+		}
+	}
+	else if (chakra::IsArray(Value))
 	{
 		JsValueRef arr = Value;
 		int len = chakra::Length(arr);
@@ -5280,6 +6245,10 @@ void FJavascriptContextImplementation::FromValue<FStructDummy>(FStructDummy* Ptr
 				chakra::Throw(FString::Printf(TEXT("Wrong struct type (given:%s), (expected:%s)"), *GivenStruct->GetName(), *ScriptStruct->GetName()));
 			}
 		}
+		else if (FJavascriptMathStructs::Read(Value, ScriptStruct, reinterpret_cast<uint8*>(Ptr)))
+		{
+			// core math struct from a plain object or packed components
+		}
 		else if (ScriptStruct->IsChildOf(FJavascriptFunction::StaticStruct()))
 		{
 			FJavascriptFunction func;
@@ -5289,6 +6258,7 @@ void FJavascriptContextImplementation::FromValue<FStructDummy>(FStructDummy* Ptr
 				func.Handle = MakeShareable(new FPrivateJavascriptFunction);
 				func.Handle->context.Reset(context());
 				func.Handle->Function.Reset(jsfunc);
+				ExportedFunctions.Add(func.Handle);
 			}
 			ScriptStruct->CopyScriptStruct(Ptr, &func);
 		}
@@ -5301,6 +6271,7 @@ void FJavascriptContextImplementation::FromValue<FStructDummy>(FStructDummy* Ptr
 				JsValueRef jsobj = Value;
 				ref.Handle = MakeShareable(new FPrivateJavascriptRef);
 				ref.Handle->Object.Reset(jsobj);
+				ExportedRefs.Add(ref.Handle);
 			}
 
 			ScriptStruct->CopyScriptStruct(Ptr, &ref);
@@ -5356,6 +6327,8 @@ inline void FJavascriptContextImplementation::AddReferencedObjects(UObject * InT
 		auto Object = It.Key();
 		if (Object->IsPendingKill())
 		{
+			ProxyFunctionCache.Remove(Object);
+			WrapperCensus.OnReleased(Object);
 			It.RemoveCurrent();
 		}
 		else
@@ -5364,18 +6337,25 @@ inline void FJavascriptContextImplementation::AddReferencedObjects(UObject * InT
 		}
 	}
 
-	// All structs
-	for (auto It = MemoryToObjectMap.CreateIterator(); It; ++It)
+	// All structs, once per type rather than per instance
+	for (auto It = StructInstanceTypes.CreateIterator(); It; ++It)
 	{
-		TSharedPtr<FStructMemoryInstance> StructScript = It.Key();
-		if (!StructScript.IsValid() || StructScript->Struct->IsPendingKill())
+		UScriptStruct* Struct = It.Key();
+		if (!Struct->IsPendingKill())
 		{
-			It.RemoveCurrent();
+			Collector.AddReferencedObject(Struct, InThis);
+			continue;
 		}
-		else
+
+		// wrappers may still be reachable, they get released when collected
+		for (auto& StructScript : StructInstances)
 		{
-			Collector.AddReferencedObject(StructScript->Struct, InThis);
+			if (StructScript->Struct == Struct && !StructScript->bOrphaned)
+			{
+				StructScript->Orphan();
+			}
 		}
+		It.RemoveCurrent();
 	}
 
 	// All class definitions
@@ -5417,7 +6397,7 @@ bool TStructReader<CppType>::Read(JsValueRef Value, CppType& Target) const
 void FPendingClassConstruction::Finalize(FJavascriptContext* Context, UObject* UnrealObject)
 {
 	static_cast<FJavascriptContextImplementation*>(Context)->RegisterObject(UnrealObject, Object.Get());
-	chakra::SetProperty(Object.Get(), "__self", chakra::External(UnrealObject, nullptr));
+	chakra::SetNativeHandle(Object.Get(), UnrealObject, ENativeHandleType::Object);
 	//Object->SetAlignedPointerInInternalField(0, UnrealObject);
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "JavascriptIsolate_Private.h"
+#include "JavascriptStartup.h"
+#include "JavascriptRuntimeBindings.h"
 
 struct FStructMemoryInstance;
 struct FJavascriptContext;
@@ -31,8 +33,11 @@ struct FJavascriptContext : TSharedFromThis<FJavascriptContext>
 	/** A map from Unreal UObject to V8 Object */
 	TMap< UObject*, Persistent<JsValueRef> > ObjectToObjectMap;
 
-	/** A map from Struct buffer to V8 Object */
-	TMap< TSharedPtr<FStructMemoryInstance>, Persistent<JsValueRef> > MemoryToObjectMap;
+	/** Struct instances exported to script, each one released when its wrapper is collected */
+	TSparseArray< TSharedPtr<FStructMemoryInstance> > StructInstances;
+
+	/** Number of live instances per struct type, so that UE GC is told about each type once */
+	TMap< UScriptStruct*, int32 > StructInstanceTypes;
 
 	virtual ~FJavascriptContext() {}
 	virtual void Expose(FString RootName, UObject* Object) = 0;
@@ -58,6 +63,9 @@ struct FJavascriptContext : TSharedFromThis<FJavascriptContext>
 
 	virtual void UncaughtException(const FString& Exception) = 0;
 
+	virtual FString GetWrapperCensus(bool bSinceSnapshot) = 0;
+	virtual void SnapshotWrappers() = 0;
+
 	//virtual v8::Isolate* isolate() = 0;
 	virtual JsContextRef context() = 0;
 	virtual JsValueRef ExportObject(UObject* Object, bool bForce = false) = 0;
@@ -85,12 +93,13 @@ struct FJavascriptContext : TSharedFromThis<FJavascriptContext>
 	/** A map from Unreal UScriptStruct to V8 Function template */
 	TMap< UScriptStruct*, Persistent<JsValueRef> > ScriptStructToFunctionTemplateMap;	
 
-	/** BlueprintFunctionLibrary function mapping */
-	TMultiMap< const UStruct*, UFunction*> BlueprintFunctionLibraryMapping;
-
-	TMultiMap< const UStruct*, UFunction*> BlueprintFunctionLibraryFactoryMapping;
+	/** BlueprintFunctionLibrary function mapping, shared by the contexts of a runtime */
+	virtual const FJavascriptLibraryMapping& GetLibraryMapping() = 0;
 
 	TArray<FPendingClassConstruction> ObjectUnderConstructionStack;
 
+	/** Where the time to bring up this context went, until its first script file has run */
+	FJavascriptStartupRecord Startup;
+
 	JsRuntimeHandle runtime_;
 };
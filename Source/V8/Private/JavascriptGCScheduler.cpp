@@ -0,0 +1,127 @@
+#include "JavascriptGCScheduler.h"
+#include "Translator.h"
+#include "JavascriptStats.h"
+#include "JavascriptTrace.h"
+#include "HAL/IConsoleManager.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+static TAutoConsoleVariable<float> CVarGCMinGrowth(
+	TEXT("javascript.GC.MinGrowthMB"),
+	4.0f,
+	TEXT("Heap growth since the last collection before one is scheduled into idle time, in megabytes"));
+
+static TAutoConsoleVariable<float> CVarGCGrowthFactor(
+	TEXT("javascript.GC.GrowthFactor"),
+	0.5f,
+	TEXT("Heap growth since the last collection before one is scheduled, relative to the heap left by it (the larger of this and MinGrowthMB applies)"));
+
+static TAutoConsoleVariable<float> CVarGCForceFactor(
+	TEXT("javascript.GC.ForceFactor"),
+	3.0f,
+	TEXT("Multiple of the scheduling threshold at which a collection runs even if it doesn't fit into the frame budget"));
+
+static TAutoConsoleVariable<float> CVarGCLookahead(
+	TEXT("javascript.GC.Lookahead"),
+	0.5f,
+	TEXT("Seconds of allocation at the current rate taken into account, so collections happen in idle time before the threshold is crossed"));
+
+namespace
+{
+	// weight of the latest sample in smoothed values
+	const double SmoothingFactor = 0.3;
+
+	// first pause estimate, 1ms per megabyte of heap
+	const double InitialPausePerByte = 0.001 / (1024 * 1024);
+
+	// heap usage closer than this to the memory limit forces a collection
+	const double MemoryLimitMargin = 0.9;
+}
+
+FJavascriptGCScheduler::FJavascriptGCScheduler()
+	: UsageAfterCollection(0)
+	, LastUsage(0)
+	, AllocationRate(0)
+	, PausePerByte(InitialPausePerByte)
+{
+}
+
+size_t FJavascriptGCScheduler::GetUsage(JsRuntimeHandle Runtime)
+{
+	size_t Usage = 0;
+	JsGetRuntimeMemoryUsage(Runtime, &Usage);
+	return Usage;
+}
+
+bool FJavascriptGCScheduler::Tick(JsRuntimeHandle Runtime, float DeltaTime, double RemainingBudgetInSeconds)
+{
+	const size_t Usage = GetUsage(Runtime);
+
+	// the heap shrank on its own, the runtime collected or a script called gc()
+	if (Usage < UsageAfterCollection || Usage + (size_t)(1024 * 1024) < LastUsage)
+	{
+		UsageAfterCollection = Usage;
+	}
+
+	if (DeltaTime > 0 && Usage > LastUsage)
+	{
+		const double Rate = (double)(Usage - LastUsage) / DeltaTime;
+		AllocationRate += (Rate - AllocationRate) * SmoothingFactor;
+	}
+	else if (DeltaTime > 0)
+	{
+		AllocationRate -= AllocationRate * SmoothingFactor;
+	}
+	LastUsage = Usage;
+
+	const double Growth = (double)(Usage - FMath::Min(Usage, UsageAfterCollection));
+	const double Threshold = FMath::Max(CVarGCMinGrowth.GetValueOnGameThread() * 1024.0 * 1024.0, UsageAfterCollection * (double)CVarGCGrowthFactor.GetValueOnGameThread());
+	const double ExpectedGrowth = Growth + AllocationRate * CVarGCLookahead.GetValueOnGameThread();
+
+	bool bForce = Growth >= Threshold * CVarGCForceFactor.GetValueOnGameThread();
+
+	size_t Limit = 0;
+	if (JsGetRuntimeMemoryLimit(Runtime, &Limit) == JsNoError && Limit != (size_t)-1 && Limit > 0)
+	{
+		bForce |= Usage + AllocationRate * CVarGCLookahead.GetValueOnGameThread() >= Limit * MemoryLimitMargin;
+	}
+
+	const bool bFits = ExpectedGrowth >= Threshold && PausePerByte * Usage <= RemainingBudgetInSeconds;
+	if (!bForce && !bFits)
+	{
+		return false;
+	}
+
+	if (bForce && !bFits)
+	{
+		INC_DWORD_STAT(STAT_JavascriptGCOverBudget);
+	}
+
+	Collect(Runtime);
+	return true;
+}
+
+void FJavascriptGCScheduler::Collect(JsRuntimeHandle Runtime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_JavascriptGC);
+	FJavascriptTraceScope TraceScope(TEXT("GarbageCollection"));
+
+	const size_t UsageBefore = GetUsage(Runtime);
+	const double StartTime = FPlatformTime::Seconds();
+
+	JsCheck(JsCollectGarbage(Runtime));
+
+	const double Pause = FPlatformTime::Seconds() - StartTime;
+	if (UsageBefore > 0)
+	{
+		PausePerByte += (Pause / UsageBefore - PausePerByte) * SmoothingFactor;
+	}
+
+	UsageAfterCollection = LastUsage = GetUsage(Runtime);
+
+	SET_FLOAT_STAT(STAT_JavascriptGCPause, Pause * 1000.0);
+
+	UE_LOG(Javascript, Verbose, TEXT("GC took %.2fms, heap %llu -> %llu bytes"), Pause * 1000.0, (uint64)UsageBefore, (uint64)UsageAfterCollection);
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Moves garbage collections of a runtime into the idle time left at the end of the frame.
+// A collection is scheduled once the heap has grown enough since the last one (or will have, judging
+// by the allocation rate) and its estimated pause fits into the remaining budget. It is forced regardless
+// of the budget when the heap outgrows the threshold by far or is about to hit the runtime's memory limit,
+// which still beats the engine collecting at an arbitrary point mid-frame.
+class FJavascriptGCScheduler
+{
+public:
+	FJavascriptGCScheduler();
+
+	// Once per frame, after the runtime's scripts ran. Returns whether a collection happened.
+	bool Tick(JsRuntimeHandle Runtime, float DeltaTime, double RemainingBudgetInSeconds);
+
+	// Full collection right away, measured like scheduled ones
+	void Collect(JsRuntimeHandle Runtime);
+
+private:
+	static size_t GetUsage(JsRuntimeHandle Runtime);
+
+	size_t UsageAfterCollection;
+	size_t LastUsage;
+
+	// bytes per second, smoothed
+	double AllocationRate;
+	// pause per byte of heap, smoothed
+	double PausePerByte;
+};
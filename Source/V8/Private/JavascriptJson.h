@@ -0,0 +1,40 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Helpers for the JSON written by the profilers and reports, which is assembled by hand
+struct FJavascriptJson
+{
+	// Contents of a JSON string literal (RFC 8259), without the surrounding quotes
+	static FString Escape(const FString& In)
+	{
+		FString Out;
+		Out.Reserve(In.Len() + 8);
+
+		for (TCHAR Char : In)
+		{
+			switch (Char)
+			{
+			case TEXT('"'): Out += TEXT("\\\""); break;
+			case TEXT('\\'): Out += TEXT("\\\\"); break;
+			case TEXT('\b'): Out += TEXT("\\b"); break;
+			case TEXT('\f'): Out += TEXT("\\f"); break;
+			case TEXT('\n'): Out += TEXT("\\n"); break;
+			case TEXT('\r'): Out += TEXT("\\r"); break;
+			case TEXT('\t'): Out += TEXT("\\t"); break;
+			default:
+				if (Char < 0x20)
+				{
+					Out += FString::Printf(TEXT("\\u%04x"), (uint32)Char);
+				}
+				else
+				{
+					Out.AppendChar(Char);
+				}
+				break;
+			}
+		}
+
+		return Out;
+	}
+};
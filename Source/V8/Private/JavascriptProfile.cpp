@@ -1,32 +1,36 @@
 #include "JavascriptProfile.h"
-#include "Config.h"
-#include "Translator.h"
-#include "Helpers.h"
+#include "JavascriptProfiler.h"
 #include "JavascriptLibrary.h"
+#include "IV8.h"
+#include "Misc/FileHelper.h"
 
-#if NODE_PROFILING
-#include "v8-profiler.h"
-
-using namespace v8;
+namespace
+{
+	const FJavascriptProfileNodeData* GetNodeData(const FJavascriptProfileNode& Node)
+	{
+		if (Node.Profile.IsValid() && Node.Profile->Nodes.IsValidIndex(Node.Index))
+		{
+			return &Node.Profile->Nodes[Node.Index];
+		}
+		return nullptr;
+	}
+}
 
 void UJavascriptProfile::BeginDestroy()
 {
 	Super::BeginDestroy();
 
-	if (Profile)
-	{
-		reinterpret_cast<CpuProfile*>(Profile)->Delete();
-		Profile = nullptr;
-	}
+	Profile.Reset();
 }
 
 FJavascriptProfileNode UJavascriptProfile::GetTopDownRoot()
 {
-	FJavascriptProfileNode out{ nullptr };
-	
-	if (Profile)
+	FJavascriptProfileNode out;
+
+	if (Profile.IsValid())
 	{
-		out.Node = reinterpret_cast<CpuProfile*>(Profile)->GetTopDownRoot();
+		out.Profile = Profile;
+		out.Index = 0;
 	}
 
 	return out;
@@ -34,9 +38,9 @@ FJavascriptProfileNode UJavascriptProfile::GetTopDownRoot()
 
 int32 UJavascriptProfile::GetSamplesCount()
 {
-	if (Profile)
+	if (Profile.IsValid())
 	{
-		return reinterpret_cast<CpuProfile*>(Profile)->GetSamplesCount();
+		return Profile->Samples.Num();
 	}
 
 	return 0;
@@ -44,11 +48,12 @@ int32 UJavascriptProfile::GetSamplesCount()
 
 FJavascriptProfileNode UJavascriptProfile::GetSample(int32 index)
 {
-	FJavascriptProfileNode out{ nullptr };
+	FJavascriptProfileNode out;
 
-	if (Profile)
+	if (Profile.IsValid() && Profile->Samples.IsValidIndex(index))
 	{
-		out.Node = reinterpret_cast<CpuProfile*>(Profile)->GetSample(index);
+		out.Profile = Profile;
+		out.Index = Profile->Samples[index];
 	}
 
 	return out;
@@ -56,32 +61,45 @@ FJavascriptProfileNode UJavascriptProfile::GetSample(int32 index)
 
 float UJavascriptProfile::GetSampleTimestamp(int32 index)
 {
-	if (Profile)
+	if (Profile.IsValid() && Profile->Timestamps.IsValidIndex(index))
 	{
-		return (float)reinterpret_cast<CpuProfile*>(Profile)->GetSampleTimestamp(index);
+		// microseconds since start
+		return (float)((Profile->Timestamps[index] - Profile->StartTime) * 1000000.0);
 	}
 
 	return -1;
 }
 
+bool UJavascriptProfile::Save(const FString& Filename)
+{
+	if (!Profile.IsValid())
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveStringToFile(Profile->ToCpuProfile(), *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
 void UJavascriptProfile::Start(const FString& Title, bool bRecordSamples)
 {
-	auto isolate = Isolate::GetCurrent();
+	JsRuntimeHandle Runtime = reinterpret_cast<JsRuntimeHandle>(IV8::Get().GetRuntime());
 
-	FIsolateHelper I(isolate);
-	auto profiler = isolate->GetCpuProfiler();
+	JsContextRef Context = JS_INVALID_REFERENCE;
+	if (JsGetCurrentContext(&Context) == JsNoError && Context != JS_INVALID_REFERENCE)
+	{
+		JsGetRuntime(Context, &Runtime);
+	}
 
-	profiler->StartProfiling(I.String(Title), bRecordSamples);
+	FJavascriptProfiler::Start(Runtime, Title);
 }
 
 UJavascriptProfile* UJavascriptProfile::Stop(const FString& Title)
 {
-	auto isolate = Isolate::GetCurrent();
-
-	FIsolateHelper I(isolate);
-	auto profiler = isolate->GetCpuProfiler();
-
-	auto Profile = profiler->StopProfiling(I.String(Title));
+	auto Profile = FJavascriptProfiler::Stop(Title);
+	if (!Profile.IsValid())
+	{
+		return nullptr;
+	}
 
 	auto instance = NewObject<UJavascriptProfile>();
 	instance->Profile = Profile;
@@ -90,93 +108,88 @@ UJavascriptProfile* UJavascriptProfile::Stop(const FString& Title)
 
 void UJavascriptProfile::SetSamplingInterval(int32 us)
 {
-	auto isolate = Isolate::GetCurrent();
-
-	FIsolateHelper I(isolate);
-	auto profiler = isolate->GetCpuProfiler();
-
-	profiler->SetSamplingInterval(us);
+	FJavascriptProfiler::SetSamplingInterval(us);
 }
 
 void UJavascriptProfile::SetIdle(bool is_idle)
 {
-	auto isolate = Isolate::GetCurrent();
-
-	FIsolateHelper I(isolate);
-	auto profiler = isolate->GetCpuProfiler();
-
-	profiler->SetIdle(is_idle);
+	FJavascriptProfiler::SetIdle(is_idle);
 }
 
 FString UJavascriptLibrary::GetFunctionName(FJavascriptProfileNode Node)
 {
-	return StringFromV8(reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetFunctionName());
+	auto Data = GetNodeData(Node);
+	return Data ? Data->FunctionName : FString();
 }
 int32 UJavascriptLibrary::GetScriptId(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetScriptId();
+	auto Data = GetNodeData(Node);
+	return Data ? Data->ScriptId : 0;
 }
 FString UJavascriptLibrary::GetScriptResourceName(FJavascriptProfileNode Node)
 {
-	return StringFromV8(reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetScriptResourceName());
+	auto Data = GetNodeData(Node);
+	return Data ? Data->Url : FString();
 }
 int32 UJavascriptLibrary::GetLineNumber(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetLineNumber();
+	auto Data = GetNodeData(Node);
+	return Data ? Data->LineNumber + 1 : 0;
 }
 int32 UJavascriptLibrary::GetColumnNumber(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetColumnNumber();
+	auto Data = GetNodeData(Node);
+	return Data ? Data->ColumnNumber + 1 : 0;
 }
 int32 UJavascriptLibrary::GetHitLineCount(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetHitLineCount();
+	// no line ticks are recorded
+	return 0;
 }
 FString UJavascriptLibrary::GetBailoutReason(FJavascriptProfileNode Node)
 {
-	return ANSI_TO_TCHAR(reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetBailoutReason());
+	return FString();
 }
 int32 UJavascriptLibrary::GetHitCount(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetHitCount();
+	auto Data = GetNodeData(Node);
+	return Data ? Data->HitCount : 0;
 }
 int32 UJavascriptLibrary::GetCallUid(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetCallUid();
+	auto Data = GetNodeData(Node);
+	return Data ? (int32)HashCombine(GetTypeHash(Data->FunctionName), HashCombine(GetTypeHash(Data->ScriptId), GetTypeHash(Data->LineNumber))) : 0;
 }
 int32 UJavascriptLibrary::GetNodeId(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetNodeId();
+	return GetNodeData(Node) ? Node.Index + 1 : 0;
 }
 int32 UJavascriptLibrary::GetChildrenCount(FJavascriptProfileNode Node)
 {
-	return reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetChildrenCount();
+	auto Data = GetNodeData(Node);
+	return Data ? Data->Children.Num() : 0;
 }
 FJavascriptProfileNode UJavascriptLibrary::GetChild(FJavascriptProfileNode Node, int32 index)
 {
 	FJavascriptProfileNode out;
-	out.Node = reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetChild(index);
+	auto Data = GetNodeData(Node);
+	if (Data && Data->Children.IsValidIndex(index))
+	{
+		out.Profile = Node.Profile;
+		out.Index = Data->Children[index];
+	}
 	return out;
 }
 int32 UJavascriptLibrary::GetDeoptInfosCount(FJavascriptProfileNode Node, int32 index)
 {
-	const auto& infos = reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetDeoptInfos();
-	return infos.size();
+	// chakra doesn't report deopts
+	return 0;
 }
 FString UJavascriptLibrary::GetDeoptInfo_Reason(FJavascriptProfileNode Node, int32 index)
 {
-	const auto& infos = reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetDeoptInfos();
-	return ANSI_TO_TCHAR(infos[index].deopt_reason);
+	return FString();
 }
 FString UJavascriptLibrary::GetDeoptInfo_Stack(FJavascriptProfileNode Node, int32 index)
 {
-	FString out;
-	const auto& infos = reinterpret_cast<const CpuProfileNode*>(Node.Node)->GetDeoptInfos();
-	for (const auto& frame : infos[index].stack)
-	{
-		out.Append(FString::Printf(TEXT("%d:%d"), frame.script_id, frame.position));
-	}
-	return out;
+	return FString();
 }
-
-#endif
\ No newline at end of file
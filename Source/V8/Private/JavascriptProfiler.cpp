@@ -0,0 +1,322 @@
+#include "JavascriptProfiler.h"
+#include "Translator.h"
+#include "Helpers.h"
+#include "JavascriptJson.h"
+#include "Containers/Ticker.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+int32 FJavascriptProfiler::SamplingInterval = 1000;
+FThreadSafeBool FJavascriptProfiler::bIdle;
+
+namespace
+{
+	// one runtime is profiled at a time
+	TSharedPtr<FJavascriptProfiler> ActiveProfiler;
+}
+
+bool FJavascriptProfiler::Start(JsRuntimeHandle Runtime, const FString& Title)
+{
+	if (ActiveProfiler.IsValid())
+	{
+		UE_LOG(Javascript, Warning, TEXT("Profiler is already running (%s)"), *ActiveProfiler->Data->Title);
+		return false;
+	}
+
+	// debug mode is entered with a context of the runtime being current
+	JsContextRef Context = JS_INVALID_REFERENCE;
+	JsGetCurrentContext(&Context);
+
+	JsRuntimeHandle ContextRuntime = JS_INVALID_RUNTIME_HANDLE;
+	if (Context == JS_INVALID_REFERENCE || JsGetRuntime(Context, &ContextRuntime) != JsNoError || ContextRuntime != Runtime)
+	{
+		Context = JS_INVALID_REFERENCE;
+		JsCheck(JsCreateContext(Runtime, &Context));
+	}
+
+	TSharedPtr<FJavascriptProfiler> Profiler = MakeShareable(new FJavascriptProfiler(Runtime, Context, Title));
+	Profiler->TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Profiler](float DeltaTime) {
+		return Profiler->Tick(DeltaTime);
+	}));
+
+	ActiveProfiler = Profiler;
+	return true;
+}
+
+TSharedPtr<FJavascriptProfileData> FJavascriptProfiler::Stop(const FString& Title)
+{
+	if (!ActiveProfiler.IsValid() || ActiveProfiler->Data->Title != Title)
+	{
+		UE_LOG(Javascript, Warning, TEXT("No profiler is running with title '%s'"), *Title);
+		return nullptr;
+	}
+
+	TSharedPtr<FJavascriptProfiler> Profiler = ActiveProfiler;
+	ActiveProfiler.Reset();
+
+	// the ticker leaves debug mode once no script is running
+	Profiler->Stop();
+	if (Profiler->Thread.IsValid())
+	{
+		Profiler->Thread->WaitForCompletion();
+		Profiler->Thread.Reset();
+	}
+	Profiler->bStopped = true;
+	Profiler->Data->EndTime = FPlatformTime::Seconds();
+
+	return Profiler->Data;
+}
+
+void FJavascriptProfiler::SetSamplingInterval(int32 IntervalInMicroseconds)
+{
+	SamplingInterval = FMath::Max(IntervalInMicroseconds, 100);
+}
+
+void FJavascriptProfiler::SetIdle(bool bInIdle)
+{
+	bIdle = bInIdle;
+}
+
+FJavascriptProfiler::FJavascriptProfiler(JsRuntimeHandle InRuntime, JsContextRef InContext, const FString& Title)
+	: Runtime(InRuntime)
+	, Context(InContext)
+{
+	Data = MakeShareable(new FJavascriptProfileData);
+	Data->Title = Title;
+	Data->StartTime = Data->EndTime = FPlatformTime::Seconds();
+
+	FJavascriptProfileNodeData Root;
+	Root.FunctionName = TEXT("(root)");
+	Data->Nodes.Add(Root);
+}
+
+FJavascriptProfiler::~FJavascriptProfiler()
+{
+	if (Thread.IsValid())
+	{
+		Stop();
+		Thread->WaitForCompletion();
+	}
+}
+
+bool FJavascriptProfiler::Tick(float DeltaTime)
+{
+	if (bStopped)
+	{
+		// failed to attach
+		if (ActiveProfiler.Get() == this)
+		{
+			ActiveProfiler.Reset();
+		}
+
+		// keep ticking until debug mode could be left
+		return bAttached && !Detach();
+	}
+
+	if (!bAttached && Attach())
+	{
+		Data->StartTime = FPlatformTime::Seconds();
+
+		Thread.Reset(FRunnableThread::Create(this, TEXT("JavascriptProfiler"), 0, TPri_AboveNormal));
+	}
+
+	return true;
+}
+
+bool FJavascriptProfiler::Attach()
+{
+	FContextScope Scope(Context.Get());
+
+	JsErrorCode Err = JsDiagStartDebugging(Runtime, OnDebugEvent, this);
+	if (Err == JsErrorRuntimeInUse)
+	{
+		return false;
+	}
+	else if (Err != JsNoError)
+	{
+		UE_LOG(Javascript, Error, TEXT("Failed to start profiler '%s' (%d), is a debugger attached?"), *Data->Title, (int)Err);
+		bStopped = true;
+		return false;
+	}
+
+	JsDiagSetBreakOnException(Runtime, JsDiagBreakOnExceptionAttributeNone);
+
+	bAttached = true;
+	return true;
+}
+
+bool FJavascriptProfiler::Detach()
+{
+	FContextScope Scope(Context.Get());
+
+	void* CallbackState = nullptr;
+	JsErrorCode Err = JsDiagStopDebugging(Runtime, &CallbackState);
+	if (Err == JsErrorRuntimeInUse)
+	{
+		return false;
+	}
+
+	bAttached = false;
+	return true;
+}
+
+uint32 FJavascriptProfiler::Run()
+{
+	while (!bStopRequested)
+	{
+		FPlatformProcess::Sleep(SamplingInterval / 1000000.0f);
+
+		// a break is delivered on the next statement, don't pile them up while no script is running
+		if (!bIdle && !bBreakPending && !bStopRequested)
+		{
+			bBreakPending = true;
+			JsDiagRequestAsyncBreak(Runtime);
+		}
+	}
+
+	return 0;
+}
+
+void FJavascriptProfiler::Stop()
+{
+	bStopRequested = true;
+}
+
+void CHAKRA_CALLBACK FJavascriptProfiler::OnDebugEvent(JsDiagDebugEvent DebugEvent, JsValueRef EventData, void* CallbackState)
+{
+	// breakpoints and debugger statements just continue
+	if (DebugEvent == JsDiagDebugEventAsyncBreak)
+	{
+		reinterpret_cast<FJavascriptProfiler*>(CallbackState)->TakeSample();
+	}
+}
+
+void FJavascriptProfiler::TakeSample()
+{
+	bBreakPending = false;
+
+	if (bStopped)
+	{
+		return;
+	}
+
+	JsValueRef StackTrace = JS_INVALID_REFERENCE;
+	if (JsDiagGetStackTrace(&StackTrace) != JsNoError)
+	{
+		return;
+	}
+
+	// frames are innermost first
+	int32 Node = 0;
+	for (int32 Index = chakra::Length(StackTrace) - 1; Index >= 0; --Index)
+	{
+		JsValueRef Frame = chakra::GetIndex(StackTrace, Index);
+
+		JsValueRef Function = JS_INVALID_REFERENCE;
+		if (JsDiagGetObjectFromHandle(chakra::IntFrom(chakra::GetProperty(Frame, "functionHandle")), &Function) != JsNoError)
+		{
+			continue;
+		}
+
+		Node = FindOrAddChild(Node, Function);
+	}
+
+	Data->Nodes[Node].HitCount++;
+	Data->Samples.Add(Node);
+	Data->Timestamps.Add(FPlatformTime::Seconds());
+}
+
+int32 FJavascriptProfiler::FindOrAddChild(int32 Parent, JsValueRef Function)
+{
+	JsValueRef NameValue = chakra::GetProperty(Function, "name");
+	FString Name = chakra::IsString(NameValue) ? chakra::StringFromChakra(NameValue) : FString();
+	if (Name.IsEmpty())
+	{
+		Name = TEXT("(anonymous)");
+	}
+
+	const int32 ScriptId = chakra::IntFrom(chakra::GetProperty(Function, "scriptId"));
+	const int32 Line = chakra::IntFrom(chakra::GetProperty(Function, "line"));
+	const int32 Column = chakra::IntFrom(chakra::GetProperty(Function, "column"));
+
+	for (int32 Child : Data->Nodes[Parent].Children)
+	{
+		const auto& Node = Data->Nodes[Child];
+		if (Node.ScriptId == ScriptId && Node.LineNumber == Line && Node.ColumnNumber == Column && Node.FunctionName == Name)
+		{
+			return Child;
+		}
+	}
+
+	FJavascriptProfileNodeData Node;
+	Node.FunctionName = Name;
+	Node.ScriptId = ScriptId;
+	Node.Url = GetScriptUrl(ScriptId);
+	Node.LineNumber = Line;
+	Node.ColumnNumber = Column;
+
+	const int32 Index = Data->Nodes.Add(Node);
+	Data->Nodes[Parent].Children.Add(Index);
+	return Index;
+}
+
+const FString& FJavascriptProfiler::GetScriptUrl(int32 ScriptId)
+{
+	if (!ScriptUrls.Contains(ScriptId))
+	{
+		JsValueRef Scripts = JS_INVALID_REFERENCE;
+		if (JsDiagGetScripts(&Scripts) == JsNoError)
+		{
+			for (int32 Index = 0, Num = chakra::Length(Scripts); Index < Num; ++Index)
+			{
+				JsValueRef Script = chakra::GetIndex(Scripts, Index);
+				JsValueRef FileName = chakra::GetProperty(Script, "fileName");
+				ScriptUrls.Add(chakra::IntFrom(chakra::GetProperty(Script, "scriptId")), chakra::IsString(FileName) ? chakra::StringFromChakra(FileName) : FString());
+			}
+		}
+	}
+
+	return ScriptUrls.FindOrAdd(ScriptId);
+}
+
+FString FJavascriptProfileData::ToCpuProfile() const
+{
+	auto ToMicroseconds = [](double Seconds) { return (int64)(Seconds * 1000000.0); };
+
+	FString Out = TEXT("{\"nodes\":[");
+	for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+	{
+		const auto& Node = Nodes[Index];
+
+		FString Children;
+		for (int32 Child : Node.Children)
+		{
+			Children += FString::Printf(TEXT("%s%d"), Children.IsEmpty() ? TEXT("") : TEXT(","), Child + 1);
+		}
+
+		Out += FString::Printf(TEXT("%s{\"id\":%d,\"callFrame\":{\"functionName\":\"%s\",\"scriptId\":\"%d\",\"url\":\"%s\",\"lineNumber\":%d,\"columnNumber\":%d},\"hitCount\":%d,\"children\":[%s]}"),
+			Index ? TEXT(",") : TEXT(""), Index + 1,
+			*FJavascriptJson::Escape(Node.FunctionName), Node.ScriptId, *FJavascriptJson::Escape(Node.Url), Node.LineNumber, Node.ColumnNumber,
+			Node.HitCount, *Children);
+	}
+
+	Out += FString::Printf(TEXT("],\"startTime\":%lld,\"endTime\":%lld,\"samples\":["), ToMicroseconds(StartTime), ToMicroseconds(EndTime));
+	for (int32 Index = 0; Index < Samples.Num(); ++Index)
+	{
+		Out += FString::Printf(TEXT("%s%d"), Index ? TEXT(",") : TEXT(""), Samples[Index] + 1);
+	}
+
+	Out += TEXT("],\"timeDeltas\":[");
+	int64 Last = ToMicroseconds(StartTime);
+	for (int32 Index = 0; Index < Timestamps.Num(); ++Index)
+	{
+		const int64 Now = ToMicroseconds(Timestamps[Index]);
+		Out += FString::Printf(TEXT("%s%lld"), Index ? TEXT(",") : TEXT(""), Now - Last);
+		Last = Now;
+	}
+	Out += TEXT("]}");
+
+	return Out;
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
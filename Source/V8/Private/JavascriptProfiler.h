@@ -0,0 +1,88 @@
+#pragma once
+
+#include "V8PCH.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeBool.h"
+
+// A node of the top-down call tree, fields follow the .cpuprofile format
+struct FJavascriptProfileNodeData
+{
+	FString FunctionName;
+	int32 ScriptId = 0;
+	FString Url;
+	int32 LineNumber = 0; // 0-based, function definition
+	int32 ColumnNumber = 0;
+	int32 HitCount = 0;
+	TArray<int32> Children; // indices into FJavascriptProfileData::Nodes
+};
+
+struct FJavascriptProfileData
+{
+	FString Title;
+
+	// Nodes[0] is the root, node id is index + 1
+	TArray<FJavascriptProfileNodeData> Nodes;
+
+	// node index and time (seconds) of each sample
+	TArray<int32> Samples;
+	TArray<double> Timestamps;
+
+	double StartTime = 0;
+	double EndTime = 0;
+
+	// Chrome DevTools compatible profile
+	FString ToCpuProfile() const;
+};
+
+// Samples script stacks of a runtime. A thread requests an async break at each interval,
+// the break handler records the stack on the script thread.
+// Runtimes are put into debug mode while profiling, which disables JIT.
+class FJavascriptProfiler : public FRunnable
+{
+public:
+	// Sampling starts on the next tick, when no script is running
+	static bool Start(JsRuntimeHandle Runtime, const FString& Title);
+	static TSharedPtr<FJavascriptProfileData> Stop(const FString& Title);
+
+	static void SetSamplingInterval(int32 IntervalInMicroseconds);
+
+	// No samples are requested while idle
+	static void SetIdle(bool bIdle);
+
+	virtual ~FJavascriptProfiler();
+
+	// Begin FRunnable interface.
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// End FRunnable interface.
+
+private:
+	FJavascriptProfiler(JsRuntimeHandle InRuntime, JsContextRef InContext, const FString& Title);
+
+	bool Tick(float DeltaTime);
+	bool Attach();
+	bool Detach();
+
+	static void CHAKRA_CALLBACK OnDebugEvent(JsDiagDebugEvent DebugEvent, JsValueRef EventData, void* CallbackState);
+	void TakeSample();
+	int32 FindOrAddChild(int32 Parent, JsValueRef Function);
+	const FString& GetScriptUrl(int32 ScriptId);
+
+	JsRuntimeHandle Runtime;
+	Persistent<JsContextRef> Context;
+	FDelegateHandle TickHandle;
+
+	bool bAttached = false;
+	bool bStopped = false;
+
+	TSharedPtr<FJavascriptProfileData> Data;
+	TMap<int32, FString> ScriptUrls;
+
+	TUniquePtr<FRunnableThread> Thread;
+	FThreadSafeBool bStopRequested;
+	FThreadSafeBool bBreakPending;
+
+	static int32 SamplingInterval;
+	static FThreadSafeBool bIdle;
+};
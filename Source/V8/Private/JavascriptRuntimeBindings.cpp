@@ -0,0 +1,391 @@
+#include "JavascriptRuntimeBindings.h"
+#include "Helpers.h"
+#include "Config.h"
+#include "Engine/World.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/UObjectGlobals.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/UnrealType.h"
+#include "UObject/UObjectArray.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+namespace
+{
+	TMap<JsRuntimeHandle, TUniquePtr<FJavascriptRuntimeBindings>> Runtimes;
+
+	FDelegateHandle ObjectsReplacedHandle;
+	FDelegateHandle ReloadCompleteHandle;
+	FDelegateHandle CompiledInHandle;
+	FDelegateHandle PostEngineInitHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+
+	FThreadSafeCounter TypesGeneration;
+
+	// loaded packages and script-created classes bring types without any of the hooks above firing;
+	// objects may be created on the async loading thread
+	struct FTypeCreateListener : public FUObjectArray::FUObjectCreateListener
+	{
+		virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override
+		{
+			UClass* Class = Object->GetClass();
+			if (Class && Class->IsChildOf(UField::StaticClass()))
+			{
+				TypesGeneration.Increment();
+			}
+		}
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 22
+		virtual void OnUObjectArrayShutdown() override
+		{
+			GUObjectArray.RemoveUObjectCreateListener(this);
+		}
+#endif
+	} TypeCreateListener;
+
+	void AddLibraryFunctions(FJavascriptLibraryMapping& Mapping, UClass* Class)
+	{
+		// Iterate over all functions
+		for (TFieldIterator<UFunction> FuncIt(Class, EFieldIteratorFlags::ExcludeSuper); FuncIt; ++FuncIt)
+		{
+			auto Function = *FuncIt;
+			TFieldIterator<UProperty> It(Function);
+
+			// It should be a static function
+			if ((Function->FunctionFlags & FUNC_Static) && It)
+			{
+				// and have first argument to bind with.
+				if ((It->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm)
+				{
+					// The first argument should be type of object
+					if (auto p = Cast<UObjectPropertyBase>(*It))
+					{
+						auto TargetClass = p->PropertyClass;
+
+						// GetWorld() may fail and crash, so target class is bound to UWorld
+						if (TargetClass == UObject::StaticClass() && (p->GetName() == TEXT("WorldContextObject") || p->GetName() == TEXT("WorldContext")))
+						{
+							TargetClass = UWorld::StaticClass();
+						}
+
+						Mapping.Functions.Add(TargetClass, Function);
+						continue;
+					}
+					else if (auto p = Cast<UStructProperty>(*It))
+					{
+						Mapping.Functions.Add(p->Struct, Function);
+						continue;
+					}
+				}
+
+				// Factory function?
+				for (auto It2 = It; It2; ++It2)
+				{
+					if ((It2->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == (CPF_Parm | CPF_ReturnParm))
+					{
+						if (auto p = Cast<UStructProperty>(*It2))
+						{
+							Mapping.Factories.Add(p->Struct, Function);
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+EPropertyAccessorKind FPropertyAccessor::GetKind(UProperty* Property)
+{
+	// fixed size arrays are sealed as a whole
+	if (Property->ArrayDim != 1) return EPropertyAccessorKind::Generic;
+
+	if (Property->IsA<UMulticastDelegateProperty>()) return EPropertyAccessorKind::MulticastDelegate;
+	if (Property->IsA<UDelegateProperty>()) return EPropertyAccessorKind::Delegate;
+	if (Property->IsA<UNumericProperty>() && !Property->IsA<UByteProperty>()) return EPropertyAccessorKind::Numeric;
+	if (Property->IsA<UBoolProperty>()) return EPropertyAccessorKind::Bool;
+	if (Property->IsA<UNameProperty>()) return EPropertyAccessorKind::Name;
+	if (Property->IsA<UStrProperty>()) return EPropertyAccessorKind::String;
+	if (Property->IsA<UTextProperty>()) return EPropertyAccessorKind::Text;
+	if (Property->IsA<UClassProperty>()) return EPropertyAccessorKind::Class;
+	if (Property->IsA<UStructProperty>()) return EPropertyAccessorKind::Struct;
+	if (Property->IsA<UArrayProperty>()) return EPropertyAccessorKind::Array;
+	if (Property->IsA<USoftObjectProperty>()) return EPropertyAccessorKind::SoftObject;
+	if (Property->IsA<UObjectPropertyBase>()) return EPropertyAccessorKind::Object;
+	if (Property->IsA<UByteProperty>() || Property->IsA<UEnumProperty>()) return EPropertyAccessorKind::Byte;
+	if (Property->IsA<USetProperty>()) return EPropertyAccessorKind::Set;
+	if (Property->IsA<UMapProperty>()) return EPropertyAccessorKind::Map;
+
+	return EPropertyAccessorKind::Generic;
+}
+
+void FJavascriptRuntimeBindings::Startup()
+{
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddStatic(&FJavascriptRuntimeBindings::HandleObjectsReplaced);
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { InvalidateAll(); });
+
+	GUObjectArray.AddUObjectCreateListener(&TypeCreateListener);
+
+	// modules loaded later may bring function libraries
+	CompiledInHandle = FCoreUObjectDelegates::CompiledInUObjectsRegisteredDelegate.AddLambda([](FName) { InvalidateAll(); });
+
+#if WITH_EDITOR
+	// the editor engine doesn't exist yet when this module starts up
+	PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([]() {
+		if (GEditor)
+		{
+			BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddStatic(&FJavascriptRuntimeBindings::InvalidateAll);
+		}
+	});
+#endif
+}
+
+void FJavascriptRuntimeBindings::Shutdown()
+{
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+	FCoreUObjectDelegates::CompiledInUObjectsRegisteredDelegate.Remove(CompiledInHandle);
+	GUObjectArray.RemoveUObjectCreateListener(&TypeCreateListener);
+
+#if WITH_EDITOR
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+#endif
+}
+
+uint32 FJavascriptRuntimeBindings::GetTypesGeneration()
+{
+	return (uint32)TypesGeneration.GetValue();
+}
+
+void FJavascriptRuntimeBindings::InvalidateAll()
+{
+	TypesGeneration.Increment();
+
+	for (auto& Pair : Runtimes)
+	{
+		Pair.Value->Invalidate(nullptr);
+	}
+}
+
+void FJavascriptRuntimeBindings::HandleObjectsReplaced(const TMap<UObject*, UObject*>& Replaced)
+{
+	TypesGeneration.Increment();
+
+	for (auto& Pair : Runtimes)
+	{
+		Pair.Value->Invalidate(&Replaced);
+	}
+}
+
+void FJavascriptRuntimeBindings::Invalidate(const TMap<UObject*, UObject*>* Replaced)
+{
+	if (!Replaced)
+	{
+		Types.Empty();
+		FunctionCallPlans.Empty();
+		AccessorsByProperty.Empty();
+		LibraryMapping.Reset();
+		return;
+	}
+
+	bool bFunctionsReplaced = false;
+	for (auto It = Types.CreateIterator(); It; ++It)
+	{
+		if (Replaced->Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = FunctionCallPlans.CreateIterator(); It; ++It)
+	{
+		if (Replaced->Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+			bFunctionsReplaced = true;
+		}
+	}
+	for (auto It = AccessorsByProperty.CreateIterator(); It; ++It)
+	{
+		if (Replaced->Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// a replaced library class takes its functions along
+	for (const auto& Pair : *Replaced)
+	{
+		if (UClass* Class = Cast<UClass>(Pair.Key))
+		{
+			bFunctionsReplaced |= Class->IsChildOf(UBlueprintFunctionLibrary::StaticClass());
+		}
+	}
+
+	if (bFunctionsReplaced)
+	{
+		LibraryMapping.Reset();
+	}
+}
+
+void FJavascriptRuntimeBindings::Attach(JsRuntimeHandle Runtime)
+{
+	check(IsInGameThread());
+	Runtimes.Add(Runtime, MakeUnique<FJavascriptRuntimeBindings>());
+}
+
+void FJavascriptRuntimeBindings::Detach(JsRuntimeHandle Runtime)
+{
+	check(IsInGameThread());
+	Runtimes.Remove(Runtime);
+}
+
+FJavascriptRuntimeBindings* FJavascriptRuntimeBindings::Find(JsRuntimeHandle Runtime)
+{
+	const auto* Bindings = Runtimes.Find(Runtime);
+	return Bindings ? Bindings->Get() : nullptr;
+}
+
+const FJavascriptTypeBinding& FJavascriptRuntimeBindings::GetTypeBinding(UStruct* Type)
+{
+	TUniquePtr<FJavascriptTypeBinding>& Binding = Types.FindOrAdd(Type);
+	if (Binding.IsValid() && Binding->Type.Get() == Type)
+	{
+		return *Binding;
+	}
+
+	Binding = MakeUnique<FJavascriptTypeBinding>();
+	Binding->Type = Type;
+
+	if (UClass* Class = Cast<UClass>(Type))
+	{
+		for (TFieldIterator<UFunction> FuncIt(Class, EFieldIteratorFlags::ExcludeSuper); FuncIt; ++FuncIt)
+		{
+			UFunction* Function = *FuncIt;
+			if (FV8Config::CanExportFunction(Class, Function))
+			{
+				Binding->Functions.Add(Function);
+			}
+		}
+	}
+
+	for (TFieldIterator<UProperty> PropertyIt(Type, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
+	{
+		UProperty* Property = *PropertyIt;
+		if (FV8Config::CanExportProperty(Type, Property))
+		{
+			Binding->Properties.Add({ GetAccessor(Property), PropertyNameToString(Property), !FV8Config::IsWriteDisabledProperty(Property) });
+		}
+	}
+
+	return *Binding;
+}
+
+TSharedRef<const FPropertyAccessor> FJavascriptRuntimeBindings::GetAccessor(UProperty* Property)
+{
+	// a property allocated where a collected one used to be may be of another kind
+	TSharedPtr<const FPropertyAccessor>& Accessor = AccessorsByProperty.FindOrAdd(Property);
+	if (!Accessor.IsValid() || Accessor->Kind != FPropertyAccessor::GetKind(Property))
+	{
+		Accessor = MakeShared<FPropertyAccessor>(Property);
+	}
+	return Accessor.ToSharedRef();
+}
+
+TSharedRef<const FFunctionCallPlan> FJavascriptRuntimeBindings::GetFunctionCallPlan(UFunction* Function)
+{
+	TSharedPtr<const FFunctionCallPlan>& CachedPlan = FunctionCallPlans.FindOrAdd(Function);
+	if (CachedPlan.IsValid() && CachedPlan->Function.Get() == Function)
+	{
+		return CachedPlan.ToSharedRef();
+	}
+
+	// calls still running keep the plan they started with
+	auto Plan = MakeShared<FFunctionCallPlan>();
+	Plan->Function = Function;
+
+	// Input parameters come first, up to the return parameter
+	int32 ArgIndex = 0;
+	bool bInputs = true;
+	for (TFieldIterator<UProperty> It(Function); It; ++It, ++ArgIndex)
+	{
+		UProperty* Param = *It;
+		auto PropertyFlags = Param->GetPropertyFlags();
+
+		if (bInputs && (PropertyFlags & (CPF_Parm | CPF_ReturnParm)) != CPF_Parm)
+		{
+			bInputs = false;
+		}
+
+		if (bInputs)
+		{
+			Plan->InParams.Add(Param);
+		}
+
+		if (PropertyFlags & CPF_ReturnParm)
+		{
+			if (!Plan->ReturnParam)
+			{
+				Plan->ReturnParam = Param;
+			}
+		}
+		// rejects 'const T&' and pass 'T&' as its name
+		else if ((PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
+		{
+			Plan->OutParams.Add({ Param, ArgIndex, chakra::PropertyID(Param) });
+		}
+
+		if (PropertyFlags & CPF_Parm)
+		{
+			if (!(PropertyFlags & CPF_ZeroConstructor))
+			{
+				Plan->ParamsToInitialize.Add(Param);
+			}
+
+			if (!(PropertyFlags & (CPF_IsPlainOldData | CPF_NoDestructor)))
+			{
+				Plan->ParamsToDestroy.Add(Param);
+			}
+		}
+	}
+
+	if (Plan->ReturnParam && Plan->OutParams.Num())
+	{
+		Plan->ReturnId = chakra::PropertyID("$");
+	}
+
+	CachedPlan = Plan;
+	return Plan;
+}
+
+TSharedRef<const FJavascriptLibraryMapping> FJavascriptRuntimeBindings::GetLibraryMapping()
+{
+	// contexts holding the previous mapping keep it until they fetch this one
+	if (!LibraryMapping.IsValid())
+	{
+		TArray<UClass*> Classes;
+		GetDerivedClasses(UBlueprintFunctionLibrary::StaticClass(), Classes);
+
+		auto Mapping = MakeShared<FJavascriptLibraryMapping>();
+		for (UClass* Class : Classes)
+		{
+			AddLibraryFunctions(*Mapping, Class);
+		}
+
+		LibraryMapping = Mapping;
+	}
+
+	return LibraryMapping.ToSharedRef();
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
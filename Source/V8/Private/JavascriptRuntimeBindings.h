@@ -0,0 +1,134 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Conversion of an exported property, picked once instead of casting on every access
+enum class EPropertyAccessorKind : uint8
+{
+	Generic,
+	MulticastDelegate,
+	Delegate,
+	Bool,
+	Numeric,
+	Name,
+	String,
+	Text,
+	Class,
+	Struct,
+	Array,
+	SoftObject,
+	Object,
+	Byte,
+	Set,
+	Map
+};
+
+struct FPropertyAccessor
+{
+	explicit FPropertyAccessor(UProperty* InProperty)
+		: Property(InProperty), Kind(GetKind(InProperty))
+	{}
+
+	UProperty* Property;
+	EPropertyAccessorKind Kind;
+
+	static EPropertyAccessorKind GetKind(UProperty* Property);
+};
+
+// Parameter layout of a UFunction called from script, built on its first call
+struct FFunctionCallPlan
+{
+	struct FOutParam
+	{
+		UProperty* Property;
+		int32 ArgIndex;
+		JsPropertyIdRef Id;
+	};
+
+	// a function collected without being replaced may have its address reused
+	FWeakObjectPtr Function;
+
+	TArray<UProperty*> InParams;
+	TArray<FOutParam> OutParams;
+	UProperty* ReturnParam = nullptr;
+	JsPropertyIdRef ReturnId = JS_INVALID_REFERENCE;
+
+	// parameters which can't be zero-initialized or need destruction
+	TArray<UProperty*> ParamsToInitialize;
+	TArray<UProperty*> ParamsToDestroy;
+};
+
+// Exportable members a type declares itself, the ones of its super are exported with the super
+struct FJavascriptTypeBinding
+{
+	struct FPropertyBinding
+	{
+		TSharedRef<const FPropertyAccessor> Accessor;
+		FString Name;
+		bool bWritable;
+	};
+
+	// a type collected without being replaced (e.g. a class created by script) may have its address reused
+	FWeakObjectPtr Type;
+
+	TArray<UFunction*> Functions;
+	TArray<FPropertyBinding> Properties;
+};
+
+// Blueprint function library functions by the type they bind to
+struct FJavascriptLibraryMapping
+{
+	/** Functions taking the type as their first argument */
+	TMultiMap<const UStruct*, UFunction*> Functions;
+
+	/** Functions returning the struct */
+	TMultiMap<const UStruct*, UFunction*> Factories;
+};
+
+// Binding metadata derived from reflection, built once per runtime and shared by all of its contexts.
+// Script objects themselves (templates, prototypes, accessor functions) stay per context: their
+// callbacks find the calling context through the function, and contexts can't share them.
+// Entries are dropped when blueprints get recompiled, classes hot reloaded or objects replaced,
+// as the functions and properties they point at go away. Game thread only, like the contexts using it.
+class FJavascriptRuntimeBindings
+{
+public:
+	// Hooks up invalidation, once per module
+	static void Startup();
+	static void Shutdown();
+
+	static void Attach(JsRuntimeHandle Runtime);
+	// Call after the runtime has been disposed
+	static void Detach(JsRuntimeHandle Runtime);
+
+	static FJavascriptRuntimeBindings* Find(JsRuntimeHandle Runtime);
+
+	// Changes whenever a type may have appeared or been replaced, so lookups that found nothing should be retried
+	static uint32 GetTypesGeneration();
+
+	const FJavascriptTypeBinding& GetTypeBinding(UStruct* Type);
+
+	// Callers keep the reference across ProcessEvent, which may invalidate the plan
+	TSharedRef<const FFunctionCallPlan> GetFunctionCallPlan(UFunction* Function);
+
+	TSharedRef<const FJavascriptLibraryMapping> GetLibraryMapping();
+
+	// Whether Mapping is the one handed out now, contexts holding a previous one should fetch it again
+	bool IsCurrent(const FJavascriptLibraryMapping& Mapping) const { return LibraryMapping.Get() == &Mapping; }
+
+private:
+	TSharedRef<const FPropertyAccessor> GetAccessor(UProperty* Property);
+
+	// Drops whatever refers to the replaced objects, or everything if Replaced is null
+	void Invalidate(const TMap<UObject*, UObject*>* Replaced);
+
+	static void InvalidateAll();
+	static void HandleObjectsReplaced(const TMap<UObject*, UObject*>& Replaced);
+
+	TMap<UStruct*, TUniquePtr<FJavascriptTypeBinding>> Types;
+	TMap<UFunction*, TSharedPtr<const FFunctionCallPlan>> FunctionCallPlans;
+	TSharedPtr<const FJavascriptLibraryMapping> LibraryMapping;
+
+	/** Contexts which exported an accessor keep it alive, their accessor functions point at it */
+	TMap<UProperty*, TSharedPtr<const FPropertyAccessor>> AccessorsByProperty;
+};
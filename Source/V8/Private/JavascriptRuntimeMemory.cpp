@@ -0,0 +1,241 @@
+#include "JavascriptRuntimeMemory.h"
+#include "JavascriptSettings.h"
+#include "JavascriptStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+namespace
+{
+	// without an explicit soft limit scripts are warned at this fraction of the hard limit
+	const double DefaultSoftLimitFraction = 0.9;
+
+	// live bytes have to drop this far below the soft limit before it can be crossed again
+	const double SoftLimitHysteresis = 0.95;
+
+	// weight of the latest sample in the allocation rate
+	const double RateSmoothingFactor = 0.3;
+
+	TMap<JsRuntimeHandle, TUniquePtr<FJavascriptRuntimeMemory>> Runtimes;
+	uint64 LastStatsFrame = MAX_uint64;
+
+	TAtomic<uint32> CollectionSerial(0);
+}
+
+static FAutoConsoleCommandWithOutputDevice RuntimeMemoryStatsCommand(
+	TEXT("javascript.MemoryStats"),
+	TEXT("Lists heap usage, allocation rate and collections per javascript runtime"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FJavascriptRuntimeMemory::DumpStats));
+
+FJavascriptRuntimeMemory::FJavascriptRuntimeMemory(FName InProfileName, int64 InSoftLimit, int64 InHardLimit)
+	: ProfileName(InProfileName)
+	, SoftLimit(InSoftLimit)
+	, HardLimit(InHardLimit)
+	, LiveBytes(0)
+	, PeakBytes(0)
+	, AllocatedBytes(0)
+	, NumCollections(0)
+	, NumFailures(0)
+	, SoftLimitSerial(0)
+	, bAboveSoftLimit(false)
+{
+	LastUpdateTime = FPlatformTime::Seconds();
+}
+
+void FJavascriptRuntimeMemory::Attach(JsRuntimeHandle Runtime, const FJavascriptRuntimeProfile& Profile)
+{
+	check(IsInGameThread());
+
+	const int64 HardLimit = (int64)Profile.MemoryLimitMB * 1024 * 1024;
+	int64 SoftLimit = (int64)Profile.SoftMemoryLimitMB * 1024 * 1024;
+	if (SoftLimit <= 0 && HardLimit > 0)
+	{
+		SoftLimit = (int64)(HardLimit * DefaultSoftLimitFraction);
+	}
+
+	auto Memory = TUniquePtr<FJavascriptRuntimeMemory>(new FJavascriptRuntimeMemory(Profile.Name, SoftLimit, HardLimit));
+	JsCheck(JsSetRuntimeMemoryAllocationCallback(Runtime, Memory.Get(), &FJavascriptRuntimeMemory::OnAllocation));
+	JsCheck(JsSetRuntimeBeforeCollectCallback(Runtime, Memory.Get(), &FJavascriptRuntimeMemory::OnBeforeCollect));
+	Runtimes.Add(Runtime, MoveTemp(Memory));
+}
+
+void FJavascriptRuntimeMemory::Detach(JsRuntimeHandle Runtime)
+{
+	check(IsInGameThread());
+	Runtimes.Remove(Runtime);
+}
+
+FJavascriptRuntimeMemory* FJavascriptRuntimeMemory::Find(JsRuntimeHandle Runtime)
+{
+	const auto* Memory = Runtimes.Find(Runtime);
+	return Memory ? Memory->Get() : nullptr;
+}
+
+void FJavascriptRuntimeMemory::AddContext(JsContextRef Context)
+{
+	check(IsInGameThread());
+	Contexts.Add(Context);
+}
+
+void FJavascriptRuntimeMemory::RemoveContext(JsContextRef Context)
+{
+	check(IsInGameThread());
+	Contexts.Remove(Context);
+}
+
+void FJavascriptRuntimeMemory::AddScriptTime(double Seconds)
+{
+	ScriptTime += Seconds;
+	bTicked = true;
+}
+
+void FJavascriptRuntimeMemory::TickRuntimes(double BudgetInSeconds)
+{
+	check(IsInGameThread());
+
+	for (auto& Pair : Runtimes)
+	{
+		FJavascriptRuntimeMemory& Memory = *Pair.Value;
+
+		// paused or idle runtimes are left alone, like their contexts
+		if (Memory.bTicked)
+		{
+			Memory.Tick(Pair.Key, FApp::GetDeltaTime(), BudgetInSeconds - Memory.ScriptTime);
+		}
+
+		Memory.ScriptTime = 0;
+		Memory.bTicked = false;
+	}
+}
+
+void FJavascriptRuntimeMemory::Tick(JsRuntimeHandle Runtime, float DeltaTime, double BudgetInSeconds)
+{
+	if (bCollectionRequested)
+	{
+		bCollectionRequested = false;
+		GCScheduler.Collect(Runtime);
+		return;
+	}
+
+	if (GCScheduler.Tick(Runtime, DeltaTime, BudgetInSeconds) || BudgetInSeconds <= 0 || Contexts.Num() == 0)
+	{
+		return;
+	}
+
+	// lets the runtime do its own housekeeping now rather than mid-frame, which needs one of its contexts
+	JsContextRef Previous = JS_INVALID_REFERENCE;
+	JsGetCurrentContext(&Previous);
+	if (JsSetCurrentContext(Contexts[0]) == JsNoError)
+	{
+		unsigned int NextIdleTick = 0;
+		JsIdle(&NextIdleTick);
+		JsSetCurrentContext(Previous);
+	}
+}
+
+bool FJavascriptRuntimeMemory::OnAllocation(void* State, JsMemoryEventType Event, size_t Size)
+{
+	auto Self = reinterpret_cast<FJavascriptRuntimeMemory*>(State);
+
+	if (Event == JsMemoryAllocate)
+	{
+		const int64 Live = (Self->LiveBytes += (int64)Size);
+		Self->AllocatedBytes += (uint64)Size;
+
+		int64 Peak = Self->PeakBytes.Load();
+		while (Live > Peak && !Self->PeakBytes.CompareExchange(Peak, Live))
+		{
+		}
+
+		if (Self->SoftLimit > 0 && Live >= Self->SoftLimit && !Self->bAboveSoftLimit.Exchange(true))
+		{
+			Self->SoftLimitSerial++;
+		}
+	}
+	else
+	{
+		// a failed allocation has been counted when it was requested
+		const int64 Live = (Self->LiveBytes -= (int64)Size);
+		if (Event == JsMemoryFailure)
+		{
+			Self->NumFailures++;
+		}
+
+		if (Self->bAboveSoftLimit.Load() && Live < Self->SoftLimit * SoftLimitHysteresis)
+		{
+			Self->bAboveSoftLimit = false;
+		}
+	}
+
+	// the hard limit itself is enforced by the runtime (JsSetRuntimeMemoryLimit)
+	return true;
+}
+
+void FJavascriptRuntimeMemory::OnBeforeCollect(void* State)
+{
+	auto Self = reinterpret_cast<FJavascriptRuntimeMemory*>(State);
+	Self->NumCollections++;
+	CollectionSerial++;
+}
+
+uint32 FJavascriptRuntimeMemory::GetCollectionSerial()
+{
+	return CollectionSerial;
+}
+
+void FJavascriptRuntimeMemory::UpdateStats()
+{
+	if (LastStatsFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastStatsFrame = GFrameCounter;
+
+	const double Now = FPlatformTime::Seconds();
+	int64 Live = 0, Peak = 0;
+	int32 Collections = 0;
+	double Rate = 0;
+
+	for (auto& Pair : Runtimes)
+	{
+		FJavascriptRuntimeMemory& Memory = *Pair.Value;
+
+		const uint64 Allocated = Memory.AllocatedBytes.Load();
+		const double Elapsed = Now - Memory.LastUpdateTime;
+		if (Elapsed > 0)
+		{
+			const double Sample = (double)(Allocated - Memory.LastAllocatedBytes) / Elapsed;
+			Memory.AllocationRate += (Sample - Memory.AllocationRate) * RateSmoothingFactor;
+		}
+		Memory.LastAllocatedBytes = Allocated;
+		Memory.LastUpdateTime = Now;
+
+		Live += Memory.LiveBytes.Load();
+		Peak += Memory.PeakBytes.Load();
+		Rate += Memory.AllocationRate;
+		Collections += Memory.NumCollections.Load();
+	}
+
+	SET_MEMORY_STAT(STAT_JavascriptHeapLive, Live);
+	SET_MEMORY_STAT(STAT_JavascriptHeapPeak, Peak);
+	SET_FLOAT_STAT(STAT_JavascriptAllocationRate, Rate / 1024.0);
+	SET_DWORD_STAT(STAT_JavascriptGCCount, Collections);
+}
+
+void FJavascriptRuntimeMemory::DumpStats(FOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("%-20s %8s %12s %12s %12s %12s %12s %8s %8s"), TEXT("Profile"), TEXT("Contexts"), TEXT("Live"), TEXT("Peak"), TEXT("KB/s"), TEXT("Soft limit"), TEXT("Hard limit"), TEXT("GCs"), TEXT("Failed"));
+	for (const auto& Pair : Runtimes)
+	{
+		const FJavascriptRuntimeMemory& Memory = *Pair.Value;
+		Ar.Logf(TEXT("%-20s %8d %12lld %12lld %12.1f %12lld %12lld %8d %8d"),
+			Memory.ProfileName.IsNone() ? TEXT("default") : *Memory.ProfileName.ToString(),
+			Memory.Contexts.Num(),
+			Memory.LiveBytes.Load(), Memory.PeakBytes.Load(), Memory.AllocationRate / 1024.0,
+			Memory.SoftLimit, Memory.HardLimit,
+			Memory.NumCollections.Load(), Memory.NumFailures.Load());
+	}
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "V8PCH.h"
+#include "JavascriptGCScheduler.h"
+#include "Templates/Atomic.h"
+
+struct FJavascriptRuntimeProfile;
+
+// Heap accounting of a runtime, fed by its allocation and collection callbacks.
+// The callbacks may come from the runtime's background threads, the counters are atomic and
+// published to the stats system from the game thread.
+// Also schedules the runtime's collections: once per frame, however many contexts share it.
+class FJavascriptRuntimeMemory
+{
+public:
+	// Starts accounting for a runtime created for Profile, game thread only
+	static void Attach(JsRuntimeHandle Runtime, const FJavascriptRuntimeProfile& Profile);
+	// Call after the runtime has been disposed
+	static void Detach(JsRuntimeHandle Runtime);
+
+	static FJavascriptRuntimeMemory* Find(JsRuntimeHandle Runtime);
+
+	// Publishes the totals of all runtimes to the stats, at most once per frame
+	static void UpdateStats();
+
+	static void DumpStats(FOutputDevice& Ar);
+
+	// Bumped by every collection of any runtime; caches keyed on script values are stale once it changes
+	static uint32 GetCollectionSerial();
+
+	// End of frame, game thread: each runtime whose contexts ticked gets one shot at collecting within
+	// what its scripts left of the budget, or otherwise at its own housekeeping
+	static void TickRuntimes(double BudgetInSeconds);
+
+	int64 GetLiveBytes() const { return LiveBytes; }
+	int64 GetPeakBytes() const { return PeakBytes; }
+	int64 GetSoftLimit() const { return SoftLimit; }
+	int64 GetHardLimit() const { return HardLimit; }
+
+	// Bumped whenever live bytes cross the soft limit upwards, contexts notify their scripts once per crossing
+	int32 GetSoftLimitSerial() const { return SoftLimitSerial; }
+
+	// Contexts created in the runtime, game thread only
+	void AddContext(JsContextRef Context);
+	void RemoveContext(JsContextRef Context);
+
+	// Time a context spent running scripts in its tick, counted against the runtime's frame budget
+	void AddScriptTime(double Seconds);
+
+	// Collects at the end of the frame regardless of the budget, once however many contexts ask
+	void RequestCollection() { bCollectionRequested = true; }
+
+	FJavascriptGCScheduler GCScheduler;
+
+private:
+	FJavascriptRuntimeMemory(FName InProfileName, int64 InSoftLimit, int64 InHardLimit);
+
+	void Tick(JsRuntimeHandle Runtime, float DeltaTime, double BudgetInSeconds);
+
+	static bool OnAllocation(void* State, JsMemoryEventType Event, size_t Size);
+	static void OnBeforeCollect(void* State);
+
+	FName ProfileName;
+	int64 SoftLimit;
+	int64 HardLimit;
+
+	TAtomic<int64> LiveBytes;
+	TAtomic<int64> PeakBytes;
+	TAtomic<uint64> AllocatedBytes;
+	TAtomic<int32> NumCollections;
+	TAtomic<int32> NumFailures;
+	TAtomic<int32> SoftLimitSerial;
+	TAtomic<bool> bAboveSoftLimit;
+
+	// allocation rate bookkeeping, game thread
+	uint64 LastAllocatedBytes = 0;
+	double LastUpdateTime = 0;
+	double AllocationRate = 0;
+
+	// frame bookkeeping, game thread
+	TArray<JsContextRef> Contexts;
+	double ScriptTime = 0;
+	bool bTicked = false;
+	bool bCollectionRequested = false;
+};
@@ -0,0 +1,276 @@
+#include "JavascriptStartup.h"
+#include "JavascriptJson.h"
+#include "JavascriptStats.h"
+#include "JavascriptTrace.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+thread_local FJavascriptStartupScope* FJavascriptStartupScope::Current = nullptr;
+
+static TAutoConsoleVariable<FString> CVarStartupBudgets(
+	TEXT("javascript.Startup.Budgets"),
+	TEXT(""),
+	TEXT("Startup budgets in ms per phase, e.g. 'Total=250,TypeExport=50'. Exceeding one is an error while automation tests run, a warning otherwise"));
+
+namespace
+{
+	// how many records the report keeps
+	const int32 MaxRecords = 64;
+
+	const TCHAR* PhaseNames[] = {
+		TEXT("AcquireRuntime"),
+		TEXT("CreateContext"),
+		TEXT("InitializeGlobalTemplate"),
+		TEXT("CopyGlobalTemplate"),
+		TEXT("ExposeGlobals"),
+		TEXT("BlueprintLibraryMapping"),
+		TEXT("TypeExport"),
+		TEXT("Bootstrap")
+	};
+	static_assert(ARRAY_COUNT(PhaseNames) == (int32)EJavascriptStartupPhase::Num, "Startup phase without a name");
+
+	FCriticalSection RecordsLock;
+	TArray<FJavascriptStartupRecord> Records;
+
+	double ToMs(uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles);
+	}
+
+	void SetStats(const FJavascriptStartupRecord& Record)
+	{
+		SET_FLOAT_STAT(STAT_JavascriptStartupTotal, ToMs(Record.GetTotalCycles()));
+		SET_FLOAT_STAT(STAT_JavascriptStartupAcquireRuntime, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::AcquireRuntime]));
+		SET_FLOAT_STAT(STAT_JavascriptStartupCreateContext, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::CreateContext]));
+		SET_FLOAT_STAT(STAT_JavascriptStartupGlobalTemplate, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::InitializeGlobalTemplate]));
+		SET_FLOAT_STAT(STAT_JavascriptStartupCopyGlobalTemplate, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::CopyGlobalTemplate]));
+		SET_FLOAT_STAT(STAT_JavascriptStartupExposeGlobals, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::ExposeGlobals]));
+		SET_FLOAT_STAT(STAT_JavascriptStartupLibraryMapping, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::BlueprintLibraryMapping]));
+		SET_FLOAT_STAT(STAT_JavascriptStartupTypeExport, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::TypeExport]));
+		SET_FLOAT_STAT(STAT_JavascriptStartupBootstrap, ToMs(Record.Cycles[(int32)EJavascriptStartupPhase::Bootstrap]));
+	}
+
+	void CheckBudgets(const FJavascriptStartupRecord& Record)
+	{
+		TArray<FString> Budgets;
+		CVarStartupBudgets.GetValueOnAnyThread().ParseIntoArray(Budgets, TEXT(","));
+
+		for (const FString& Budget : Budgets)
+		{
+			FString Name, Value;
+			if (!Budget.Split(TEXT("="), &Name, &Value))
+			{
+				UE_LOG(Javascript, Warning, TEXT("Malformed startup budget '%s'"), *Budget);
+				continue;
+			}
+			Name.TrimStartAndEndInline();
+
+			double Elapsed = -1;
+			if (Name == TEXT("Total"))
+			{
+				Elapsed = ToMs(Record.GetTotalCycles());
+			}
+			for (int32 Phase = 0; Phase < (int32)EJavascriptStartupPhase::Num; ++Phase)
+			{
+				if (Name == PhaseNames[Phase])
+				{
+					Elapsed = ToMs(Record.Cycles[Phase]);
+				}
+			}
+
+			if (Elapsed < 0)
+			{
+				UE_LOG(Javascript, Warning, TEXT("Unknown startup phase '%s' in budgets"), *Name);
+				continue;
+			}
+
+			const double Limit = FCString::Atod(*Value);
+			if (Elapsed <= Limit)
+			{
+				continue;
+			}
+
+			// errors fail the automation test which is running
+			if (GIsAutomationTesting)
+			{
+				UE_LOG(Javascript, Error, TEXT("%s: startup phase %s took %.2lfms, over its budget of %.2lfms"), *Record.Context, *Name, Elapsed, Limit);
+			}
+			else
+			{
+				UE_LOG(Javascript, Warning, TEXT("%s: startup phase %s took %.2lfms, over its budget of %.2lfms"), *Record.Context, *Name, Elapsed, Limit);
+			}
+		}
+	}
+
+	void HandleCommand(const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		if (Args.Num() == 0)
+		{
+			FJavascriptStartupReport::Dump(Ar);
+		}
+		else if (FJavascriptStartupReport::Save(Args[0]))
+		{
+			Ar.Logf(TEXT("Javascript startup report written to %s"), *Args[0]);
+		}
+		else
+		{
+			Ar.Logf(TEXT("Failed to write javascript startup report to %s"), *Args[0]);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice StartupReportCommand(
+	TEXT("javascript.StartupReport"),
+	TEXT("Lists startup phases of recently created contexts, or writes them as JSON to the given file"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&HandleCommand));
+
+uint64 FJavascriptStartupRecord::GetTotalCycles() const
+{
+	uint64 Total = 0;
+	for (uint64 PhaseCycles : Cycles)
+	{
+		Total += PhaseCycles;
+	}
+	return Total;
+}
+
+const TCHAR* FJavascriptStartupReport::GetPhaseName(EJavascriptStartupPhase Phase)
+{
+	return PhaseNames[(int32)Phase];
+}
+
+void FJavascriptStartupReport::Complete(FJavascriptStartupRecord& Record)
+{
+	Record.bComplete = true;
+
+	FString Phases;
+	for (int32 Phase = 0; Phase < (int32)EJavascriptStartupPhase::Num; ++Phase)
+	{
+		Phases += FString::Printf(TEXT("%s%s %.2lf"), Phase ? TEXT(", ") : TEXT(""), PhaseNames[Phase], ToMs(Record.Cycles[Phase]));
+	}
+	UE_LOG(Javascript, Log, TEXT("%s: started in %.2lfms (%s), %d types exported"), *Record.Context, ToMs(Record.GetTotalCycles()), *Phases, Record.NumTypesExported);
+
+	SetStats(Record);
+	CheckBudgets(Record);
+
+	FScopeLock Scope(&RecordsLock);
+	if (Records.Num() == MaxRecords)
+	{
+		Records.RemoveAt(0);
+	}
+	Records.Add(Record);
+}
+
+void FJavascriptStartupReport::Dump(FOutputDevice& Ar)
+{
+	FScopeLock Scope(&RecordsLock);
+	if (Records.Num() == 0)
+	{
+		Ar.Log(TEXT("No context has completed its startup yet"));
+		return;
+	}
+
+	for (const FJavascriptStartupRecord& Record : Records)
+	{
+		Ar.Logf(TEXT("%s (%s, %s): %.2lfms"), *Record.Context, *Record.Profile.ToString(), *Record.Script, ToMs(Record.GetTotalCycles()));
+		for (int32 Phase = 0; Phase < (int32)EJavascriptStartupPhase::Num; ++Phase)
+		{
+			Ar.Logf(TEXT("    %-28s %10.2lf"), PhaseNames[Phase], ToMs(Record.Cycles[Phase]));
+		}
+
+		TArray<TPair<FString, uint64>> Packages;
+		for (const auto& Pair : Record.TypeExportCycles)
+		{
+			Packages.Emplace(Pair.Key, Pair.Value);
+		}
+		Packages.Sort([](const TPair<FString, uint64>& A, const TPair<FString, uint64>& B) { return A.Value > B.Value; });
+
+		for (const auto& Package : Packages)
+		{
+			Ar.Logf(TEXT("        %-40s %10.2lf"), *Package.Key, ToMs(Package.Value));
+		}
+	}
+}
+
+bool FJavascriptStartupReport::Save(const FString& Filename)
+{
+	FString Json = TEXT("{\"contexts\":[");
+
+	{
+		FScopeLock Scope(&RecordsLock);
+		for (int32 Index = 0; Index < Records.Num(); ++Index)
+		{
+			const FJavascriptStartupRecord& Record = Records[Index];
+
+			FString Phases;
+			for (int32 Phase = 0; Phase < (int32)EJavascriptStartupPhase::Num; ++Phase)
+			{
+				Phases += FString::Printf(TEXT("%s\"%s\":%.3lf"), Phase ? TEXT(",") : TEXT(""), PhaseNames[Phase], ToMs(Record.Cycles[Phase]));
+			}
+
+			FString Packages;
+			for (const auto& Pair : Record.TypeExportCycles)
+			{
+				Packages += FString::Printf(TEXT("%s\"%s\":%.3lf"), Packages.IsEmpty() ? TEXT("") : TEXT(","), *FJavascriptJson::Escape(Pair.Key), ToMs(Pair.Value));
+			}
+
+			Json += FString::Printf(TEXT("%s\n{\"context\":\"%s\",\"profile\":\"%s\",\"script\":\"%s\",\"totalMs\":%.3lf,\"phasesMs\":{%s},\"typesExported\":%d,\"typeExportMsByPackage\":{%s}}"),
+				Index ? TEXT(",") : TEXT(""),
+				*FJavascriptJson::Escape(Record.Context),
+				*FJavascriptJson::Escape(Record.Profile.ToString()),
+				*FJavascriptJson::Escape(Record.Script),
+				ToMs(Record.GetTotalCycles()), *Phases, Record.NumTypesExported, *Packages);
+		}
+	}
+
+	Json += TEXT("\n]}\n");
+	return FFileHelper::SaveStringToFile(Json, *Filename);
+}
+
+FJavascriptStartupScope::FJavascriptStartupScope(FJavascriptStartupRecord& InRecord, EJavascriptStartupPhase InPhase, const UField* InType)
+	: Record(InRecord.bComplete ? nullptr : &InRecord)
+	, Phase(InPhase)
+	, Type(InType)
+{
+	if (Record)
+	{
+		Parent = Current;
+		Current = this;
+		StartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+FJavascriptStartupScope::~FJavascriptStartupScope()
+{
+	if (!Record)
+	{
+		return;
+	}
+
+	const uint64 EndCycles = FPlatformTime::Cycles64();
+	const uint64 Elapsed = EndCycles - StartCycles;
+	const uint64 Exclusive = Elapsed - FMath::Min(ChildCycles, Elapsed);
+
+	Record->Cycles[(int32)Phase] += Exclusive;
+	if (Type)
+	{
+		Record->TypeExportCycles.FindOrAdd(Type->GetOutermost()->GetName()) += Exclusive;
+		Record->NumTypesExported++;
+	}
+
+	if (Parent)
+	{
+		Parent->ChildCycles += Elapsed;
+	}
+	Current = Parent;
+
+	if (FJavascriptTrace::IsEnabled())
+	{
+		FJavascriptTrace::Record(PhaseNames[(int32)Phase], Type ? Type->GetName() : FString(), StartCycles, EndCycles);
+	}
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
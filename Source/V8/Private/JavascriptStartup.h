@@ -0,0 +1,70 @@
+#pragma once
+
+#include "V8PCH.h"
+
+enum class EJavascriptStartupPhase : uint8
+{
+	AcquireRuntime,
+	CreateContext,
+	InitializeGlobalTemplate,
+	CopyGlobalTemplate,
+	ExposeGlobals,
+	BlueprintLibraryMapping,
+	TypeExport,
+	Bootstrap,		// the first script file run on the context
+	Num
+};
+
+// Where the time to bring up one context went. Phases are exclusive of each other,
+// a type exported while bootstrapping counts as type export and not as bootstrap.
+struct FJavascriptStartupRecord
+{
+	FString Context;
+	FName Profile;
+	FString Script;
+
+	uint64 Cycles[(int32)EJavascriptStartupPhase::Num] = {};
+
+	/** Exclusive type export time per package */
+	TMap<FString, uint64> TypeExportCycles;
+	int32 NumTypesExported = 0;
+
+	/** Set once the first script file has run, nothing is recorded afterwards */
+	bool bComplete = false;
+
+	uint64 GetTotalCycles() const;
+};
+
+// Startup records of recently created contexts, published to stats, the log and 'javascript.StartupReport'.
+// Phases over their budget (javascript.Startup.Budgets) are reported as errors while automation tests run.
+class FJavascriptStartupReport
+{
+public:
+	static const TCHAR* GetPhaseName(EJavascriptStartupPhase Phase);
+
+	static void Complete(FJavascriptStartupRecord& Record);
+
+	static void Dump(FOutputDevice& Ar);
+
+	// Writes the records as JSON, returns false when the file can't be written
+	static bool Save(const FString& Filename);
+};
+
+// Times one phase of a context which hasn't completed its startup yet, exclusive of nested scopes.
+// Also shows up on the trace timeline (javascript.Trace).
+class FJavascriptStartupScope
+{
+public:
+	FJavascriptStartupScope(FJavascriptStartupRecord& InRecord, EJavascriptStartupPhase InPhase, const UField* InType = nullptr);
+	~FJavascriptStartupScope();
+
+private:
+	FJavascriptStartupRecord* Record;
+	EJavascriptStartupPhase Phase;
+	const UField* Type;
+	FJavascriptStartupScope* Parent = nullptr;
+	uint64 StartCycles = 0;
+	uint64 ChildCycles = 0;
+
+	static thread_local FJavascriptStartupScope* Current;
+};
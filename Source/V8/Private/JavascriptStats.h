@@ -2,11 +2,6 @@
 
 DECLARE_STATS_GROUP(TEXT("Javascript"), STATGROUP_Javascript, STATCAT_Advanced);
 
-DECLARE_CYCLE_STAT_EXTERN(TEXT("Scavenge"), STAT_Scavenge, STATGROUP_Javascript,V8_API);
-DECLARE_CYCLE_STAT_EXTERN(TEXT("MarkSweepCompact"), STAT_MarkSweepCompact, STATGROUP_Javascript, V8_API);
-DECLARE_CYCLE_STAT_EXTERN(TEXT("IncrementalMarking"), STAT_IncrementalMarking, STATGROUP_Javascript, V8_API);
-DECLARE_CYCLE_STAT_EXTERN(TEXT("ProcessWeakCallbacks"), STAT_ProcessWeakCallbacks, STATGROUP_Javascript, V8_API);
-
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Idle task"), STAT_V8IdleTask, STATGROUP_Javascript, V8_API);
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Delegate"), STAT_JavascriptDelegate, STATGROUP_Javascript, V8_API);
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Proxy"), STAT_JavascriptProxy, STATGROUP_Javascript, V8_API);
@@ -16,9 +11,34 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("<ue>"), STAT_JavascriptFunctionCallToEngine, STA
 DECLARE_CYCLE_STAT_EXTERN(TEXT("<js>"), STAT_JavascriptFunctionCallToJavascript, STATGROUP_Javascript, V8_API);
 
 DECLARE_CYCLE_STAT_EXTERN(TEXT("struct(naive)"), STAT_JavascriptReadOffStruct, STATGROUP_Javascript, V8_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tasks"), STAT_JavascriptTasks, STATGROUP_Javascript, V8_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Timers"), STAT_JavascriptTimerCallback, STATGROUP_Javascript, V8_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GC"), STAT_JavascriptGC, STATGROUP_Javascript, V8_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Module cache hit"), STAT_JavascriptModuleCacheHit, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Module cache miss"), STAT_JavascriptModuleCacheMiss, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Tasks run"), STAT_JavascriptTasksRun, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Tasks carried over"), STAT_JavascriptTaskQueueDepth, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Task budget overrun"), STAT_JavascriptTaskOverrun, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Struct instances"), STAT_JavascriptStructInstances, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Timers pending"), STAT_JavascriptTimers, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("GC collections"), STAT_JavascriptGCCount, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("GC over budget"), STAT_JavascriptGCOverBudget, STATGROUP_Javascript, V8_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled contexts"), STAT_JavascriptPooledContexts, STATGROUP_Javascript, V8_API);
+
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last GC pause (ms)"), STAT_JavascriptGCPause, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Allocation rate (KB/s)"), STAT_JavascriptAllocationRate, STATGROUP_Javascript, V8_API);
+
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: total (ms)"), STAT_JavascriptStartupTotal, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: acquire runtime (ms)"), STAT_JavascriptStartupAcquireRuntime, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: create context (ms)"), STAT_JavascriptStartupCreateContext, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: global template (ms)"), STAT_JavascriptStartupGlobalTemplate, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: copy global template (ms)"), STAT_JavascriptStartupCopyGlobalTemplate, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: expose globals (ms)"), STAT_JavascriptStartupExposeGlobals, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: library mapping (ms)"), STAT_JavascriptStartupLibraryMapping, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: type export (ms)"), STAT_JavascriptStartupTypeExport, STATGROUP_Javascript, V8_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Startup: bootstrap (ms)"), STAT_JavascriptStartupBootstrap, STATGROUP_Javascript, V8_API);
 
-DECLARE_MEMORY_STAT_EXTERN(TEXT("NewSpace"), STAT_NewSpace, STATGROUP_Javascript, V8_API);
-DECLARE_MEMORY_STAT_EXTERN(TEXT("OldSpace"), STAT_OldSpace, STATGROUP_Javascript, V8_API);
-DECLARE_MEMORY_STAT_EXTERN(TEXT("CodeSpace"), STAT_CodeSpace, STATGROUP_Javascript, V8_API);
-DECLARE_MEMORY_STAT_EXTERN(TEXT("MapSpace"), STAT_MapSpace, STATGROUP_Javascript, V8_API);
-DECLARE_MEMORY_STAT_EXTERN(TEXT("LoSpace"), STAT_LoSpace, STATGROUP_Javascript, V8_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Heap live"), STAT_JavascriptHeapLive, STATGROUP_Javascript, V8_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Heap peak"), STAT_JavascriptHeapPeak, STATGROUP_Javascript, V8_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Struct pool"), STAT_JavascriptStructPool, STATGROUP_Javascript, V8_API);
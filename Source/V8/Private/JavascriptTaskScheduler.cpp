@@ -0,0 +1,151 @@
+#include "JavascriptTaskScheduler.h"
+#include "Translator.h"
+#include "JavascriptStats.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+// tasks carried over by all schedulers, a gauge rather than a counter
+static int32 GTasksCarriedOver = 0;
+
+// time all contexts spent in their ticks this frame
+static uint64 GFrameBudgetFrame = MAX_uint64;
+static double GFrameBudgetSpent = 0;
+
+FJavascriptTaskScheduler::~FJavascriptTaskScheduler()
+{
+	Reset();
+}
+
+void FJavascriptTaskScheduler::Enqueue(JsValueRef Task, EJavascriptTaskPriority Priority)
+{
+	check(Priority < EJavascriptTaskPriority::Num);
+
+	JsCheck(JsAddRef(Task, nullptr));
+	Queues[(int32)Priority].Tasks.Add(Task);
+}
+
+int32 FJavascriptTaskScheduler::Run(double BudgetInSeconds, TFunctionRef<void(JsValueRef)> RunTask)
+{
+	SCOPE_CYCLE_COUNTER(STAT_JavascriptTasks);
+
+	const double Deadline = FPlatformTime::Seconds() + BudgetInSeconds;
+	int32 NumRun = 0;
+
+	for (;;)
+	{
+		FQueue* Queue = nullptr;
+		for (auto& Candidate : Queues)
+		{
+			if (Candidate.Num())
+			{
+				Queue = &Candidate;
+				break;
+			}
+		}
+
+		if (!Queue)
+		{
+			break;
+		}
+
+		if (NumRun > 0 && FPlatformTime::Seconds() >= Deadline)
+		{
+			INC_DWORD_STAT(STAT_JavascriptTaskOverrun);
+			break;
+		}
+
+		JsValueRef Task = Queue->Tasks[Queue->Head++];
+		if (Queue->Head == Queue->Tasks.Num())
+		{
+			Queue->Tasks.Reset();
+			Queue->Head = 0;
+		}
+
+		RunTask(Task);
+		JsCheck(JsRelease(Task, nullptr));
+
+		NumRun++;
+	}
+
+	// drop what has been consumed from carried over queues
+	for (auto& Queue : Queues)
+	{
+		if (Queue.Head > 0)
+		{
+			Queue.Tasks.RemoveAt(0, Queue.Head, false);
+			Queue.Head = 0;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_JavascriptTasksRun, NumRun);
+	UpdateCarriedOver(Num());
+
+	return NumRun;
+}
+
+int32 FJavascriptTaskScheduler::Num() const
+{
+	int32 Total = 0;
+	for (const auto& Queue : Queues)
+	{
+		Total += Queue.Num();
+	}
+	return Total;
+}
+
+void FJavascriptTaskScheduler::Reset()
+{
+	for (auto& Queue : Queues)
+	{
+		for (int32 Index = Queue.Head; Index < Queue.Tasks.Num(); ++Index)
+		{
+			JsRelease(Queue.Tasks[Index], nullptr);
+		}
+		Queue.Tasks.Empty();
+		Queue.Head = 0;
+	}
+	UpdateCarriedOver(0);
+}
+
+void FJavascriptTaskScheduler::UpdateCarriedOver(int32 Depth)
+{
+	GTasksCarriedOver += Depth - CarriedOver;
+	CarriedOver = Depth;
+	SET_DWORD_STAT(STAT_JavascriptTaskQueueDepth, GTasksCarriedOver);
+}
+
+double FJavascriptTaskScheduler::GetFrameBudgetLeft(double FrameBudgetInSeconds)
+{
+	if (GFrameBudgetFrame != GFrameCounter)
+	{
+		GFrameBudgetFrame = GFrameCounter;
+		GFrameBudgetSpent = 0;
+	}
+	return FMath::Max(FrameBudgetInSeconds - GFrameBudgetSpent, 0.0);
+}
+
+void FJavascriptTaskScheduler::ConsumeFrameBudget(double Seconds)
+{
+	if (GFrameBudgetFrame != GFrameCounter)
+	{
+		GFrameBudgetFrame = GFrameCounter;
+		GFrameBudgetSpent = 0;
+	}
+	GFrameBudgetSpent += Seconds;
+}
+
+EJavascriptTaskPriority FJavascriptTaskScheduler::ParsePriority(const FString& Name)
+{
+	// same names as the web scheduler API
+	if (Name == TEXT("user-blocking"))
+	{
+		return EJavascriptTaskPriority::UserBlocking;
+	}
+	else if (Name == TEXT("background"))
+	{
+		return EJavascriptTaskPriority::Background;
+	}
+	return EJavascriptTaskPriority::UserVisible;
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Lower value runs first
+enum class EJavascriptTaskPriority : uint8
+{
+	Microtask,		// promise continuations
+	UserBlocking,
+	UserVisible,
+	Background,
+	Num
+};
+
+// Pending script callbacks of a context, drained from its ticker within a time budget.
+// Tasks which don't fit into the budget are carried over to the next frame.
+class FJavascriptTaskScheduler
+{
+public:
+	~FJavascriptTaskScheduler();
+
+	void Enqueue(JsValueRef Task, EJavascriptTaskPriority Priority);
+
+	// Runs tasks in priority order until the budget is spent, at least one task runs to guarantee progress.
+	// Tasks enqueued while running are picked up within the same budget. Returns the number of tasks run.
+	int32 Run(double BudgetInSeconds, TFunctionRef<void(JsValueRef)> RunTask);
+
+	int32 Num() const;
+
+	// Releases pending tasks without running them
+	void Reset();
+
+	static EJavascriptTaskPriority ParsePriority(const FString& Name);
+
+	// What contexts left of the per-frame budget they all share, game thread only
+	static double GetFrameBudgetLeft(double FrameBudgetInSeconds);
+	// Counts time a context spent in its tick against the shared frame budget
+	static void ConsumeFrameBudget(double Seconds);
+
+private:
+	struct FQueue
+	{
+		TArray<JsValueRef> Tasks;
+		int32 Head = 0;
+
+		int32 Num() const { return Tasks.Num() - Head; }
+	};
+
+	// Publishes the depth left after a run, summed over all schedulers
+	void UpdateCarriedOver(int32 Depth);
+
+	FQueue Queues[(int32)EJavascriptTaskPriority::Num];
+
+	/** Depth this scheduler last published */
+	int32 CarriedOver = 0;
+};
@@ -0,0 +1,323 @@
+#include "JavascriptTimerWheel.h"
+#include "Translator.h"
+#include "JavascriptStats.h"
+#include "JavascriptTrace.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+namespace
+{
+	int32 CountTrailingZeros64(uint64 Value)
+	{
+		const uint32 Low = (uint32)Value;
+		return Low ? (int32)FMath::CountTrailingZeros(Low) : 32 + (int32)FMath::CountTrailingZeros((uint32)(Value >> 32));
+	}
+}
+
+FJavascriptTimerWheel::FJavascriptTimerWheel()
+	: Current(GetTimeInMs())
+	, NextHandle(1)
+	, FiringTimer(INDEX_NONE)
+	, bFiringTimerRemoved(false)
+{
+	for (int32 Bucket = 0; Bucket <= NumBuckets; ++Bucket)
+	{
+		Heads[Bucket] = Tails[Bucket] = INDEX_NONE;
+	}
+	FMemory::Memzero(Occupied);
+}
+
+FJavascriptTimerWheel::~FJavascriptTimerWheel()
+{
+	Reset();
+}
+
+uint64 FJavascriptTimerWheel::GetTimeInMs()
+{
+	return (uint64)(FPlatformTime::Seconds() * 1000.0);
+}
+
+int32 FJavascriptTimerWheel::Add(JsValueRef Callback, JsValueRef Arguments, uint32 DelayInMs, uint32 IntervalInMs)
+{
+	JsCheck(JsAddRef(Callback, nullptr));
+	if (Arguments != JS_INVALID_REFERENCE)
+	{
+		JsCheck(JsAddRef(Arguments, nullptr));
+	}
+
+	// handles are never reused, a stale clearTimeout must not cancel somebody else's timer
+	const int32 Handle = NextHandle;
+	NextHandle = NextHandle == MAX_int32 ? 1 : NextHandle + 1;
+
+	FTimer Timer;
+	Timer.Callback = Callback;
+	Timer.Arguments = Arguments;
+	Timer.Due = FMath::Max(GetTimeInMs(), Current) + DelayInMs;
+	Timer.Interval = IntervalInMs;
+	Timer.Handle = Handle;
+	Timer.Bucket = INDEX_NONE;
+	Timer.Prev = Timer.Next = INDEX_NONE;
+
+	const int32 Index = Timers.Add(Timer);
+	Handles.Add(Handle, Index);
+	Link(Index, Current + 1);
+
+	INC_DWORD_STAT(STAT_JavascriptTimers);
+	return Handle;
+}
+
+void FJavascriptTimerWheel::Remove(int32 Handle)
+{
+	int32 Index = INDEX_NONE;
+	if (!Handles.RemoveAndCopyValue(Handle, Index))
+	{
+		return;
+	}
+
+	// the callback is still running, it's released once it returns
+	if (Index == FiringTimer)
+	{
+		bFiringTimerRemoved = true;
+		return;
+	}
+
+	Unlink(Index);
+	Release(Index);
+}
+
+int32 FJavascriptTimerWheel::Advance(TFunctionRef<void(JsValueRef Callback, JsValueRef Arguments)> Fire)
+{
+	const uint64 Now = GetTimeInMs();
+	int32 NumFired = 0;
+
+	while (Current < Now)
+	{
+		if (Timers.Num() == 0)
+		{
+			Current = Now;
+			break;
+		}
+
+		const uint64 Next = GetNextEventTime();
+		if (Next > Now)
+		{
+			Current = Now;
+			break;
+		}
+
+		if ((Next & (SlotsPerLevel - 1)) == 0)
+		{
+			Cascade(Next);
+		}
+		Current = Next;
+
+		// move the slot aside, timers added or rescheduled by callbacks may land in it again
+		const int32 Bucket = (int32)(Current & (SlotsPerLevel - 1));
+		if (Heads[Bucket] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		for (int32 Index = Heads[Bucket]; Index != INDEX_NONE; Index = Timers[Index].Next)
+		{
+			Timers[Index].Bucket = ExpiringBucket;
+		}
+		Heads[ExpiringBucket] = Heads[Bucket];
+		Tails[ExpiringBucket] = Tails[Bucket];
+		Heads[Bucket] = Tails[Bucket] = INDEX_NONE;
+		Occupied[0] &= ~(1ull << Bucket);
+
+		while (Heads[ExpiringBucket] != INDEX_NONE)
+		{
+			const int32 Index = Heads[ExpiringBucket];
+			Unlink(Index);
+
+			FTimer& Timer = Timers[Index];
+			if (Timer.Interval == 0)
+			{
+				Handles.Remove(Timer.Handle);
+			}
+
+			SCOPE_CYCLE_COUNTER(STAT_JavascriptTimerCallback);
+			FJavascriptTraceScope TraceScope(TEXT("TimerCallback"));
+
+			FiringTimer = Index;
+			bFiringTimerRemoved = false;
+			Fire(Timer.Callback, Timer.Arguments);
+			FiringTimer = INDEX_NONE;
+			NumFired++;
+
+			// callbacks may have added timers, don't hold on to the reference across the call
+			FTimer& Fired = Timers[Index];
+			if (Fired.Interval == 0 || bFiringTimerRemoved)
+			{
+				Release(Index);
+				continue;
+			}
+
+			Fired.Due += Fired.Interval;
+			if (Fired.Due <= Now)
+			{
+				Fired.Due += ((Now - Fired.Due) / Fired.Interval + 1) * Fired.Interval;
+			}
+			Link(Index, Current + 1);
+		}
+	}
+
+	return NumFired;
+}
+
+int32 FJavascriptTimerWheel::Num() const
+{
+	return Timers.Num();
+}
+
+void FJavascriptTimerWheel::Reset()
+{
+	for (auto& Timer : Timers)
+	{
+		JsRelease(Timer.Callback, nullptr);
+		if (Timer.Arguments != JS_INVALID_REFERENCE)
+		{
+			JsRelease(Timer.Arguments, nullptr);
+		}
+	}
+	DEC_DWORD_STAT_BY(STAT_JavascriptTimers, Timers.Num());
+
+	Timers.Empty();
+	Handles.Empty();
+	for (int32 Bucket = 0; Bucket <= NumBuckets; ++Bucket)
+	{
+		Heads[Bucket] = Tails[Bucket] = INDEX_NONE;
+	}
+	FMemory::Memzero(Occupied);
+	FiringTimer = INDEX_NONE;
+}
+
+void FJavascriptTimerWheel::Link(int32 Index, uint64 Base)
+{
+	FTimer& Timer = Timers[Index];
+	const uint64 Due = FMath::Max(Timer.Due, Base);
+	const uint64 Delta = Due - Base;
+
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && Delta >= (1ull << (SlotBits * (Level + 1))))
+	{
+		Level++;
+	}
+
+	// beyond the last level timers wait in its farthest slot and are placed again when it cascades
+	const uint64 Horizon = 1ull << (SlotBits * NumLevels);
+	const uint64 SlotTime = Delta < Horizon ? Due : Base + Horizon - 1;
+	const int32 Slot = (int32)((SlotTime >> (SlotBits * Level)) & (SlotsPerLevel - 1));
+	const int32 Bucket = Level * SlotsPerLevel + Slot;
+
+	Timer.Bucket = Bucket;
+	Timer.Prev = Tails[Bucket];
+	Timer.Next = INDEX_NONE;
+	if (Tails[Bucket] != INDEX_NONE)
+	{
+		Timers[Tails[Bucket]].Next = Index;
+	}
+	else
+	{
+		Heads[Bucket] = Index;
+	}
+	Tails[Bucket] = Index;
+	Occupied[Level] |= 1ull << Slot;
+}
+
+void FJavascriptTimerWheel::Unlink(int32 Index)
+{
+	FTimer& Timer = Timers[Index];
+	const int32 Bucket = Timer.Bucket;
+	check(Bucket != INDEX_NONE);
+
+	if (Timer.Prev != INDEX_NONE)
+	{
+		Timers[Timer.Prev].Next = Timer.Next;
+	}
+	else
+	{
+		Heads[Bucket] = Timer.Next;
+	}
+
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Timer.Prev;
+	}
+	else
+	{
+		Tails[Bucket] = Timer.Prev;
+	}
+
+	if (Heads[Bucket] == INDEX_NONE && Bucket != ExpiringBucket)
+	{
+		Occupied[Bucket / SlotsPerLevel] &= ~(1ull << (Bucket % SlotsPerLevel));
+	}
+
+	Timer.Bucket = Timer.Prev = Timer.Next = INDEX_NONE;
+}
+
+void FJavascriptTimerWheel::Release(int32 Index)
+{
+	FTimer& Timer = Timers[Index];
+	JsRelease(Timer.Callback, nullptr);
+	if (Timer.Arguments != JS_INVALID_REFERENCE)
+	{
+		JsRelease(Timer.Arguments, nullptr);
+	}
+	Timers.RemoveAt(Index);
+
+	DEC_DWORD_STAT(STAT_JavascriptTimers);
+}
+
+void FJavascriptTimerWheel::Cascade(uint64 Time)
+{
+	// Time starts a new rotation of level 0, find the highest level it starts a rotation of too
+	int32 TopLevel = 1;
+	while (TopLevel < NumLevels - 1 && (Time & ((1ull << (SlotBits * (TopLevel + 1))) - 1)) == 0)
+	{
+		TopLevel++;
+	}
+
+	// from the top so that timers moving down are cascaded further within the same step
+	for (int32 Level = TopLevel; Level >= 1; --Level)
+	{
+		const int32 Slot = (int32)((Time >> (SlotBits * Level)) & (SlotsPerLevel - 1));
+		if (!(Occupied[Level] & (1ull << Slot)))
+		{
+			continue;
+		}
+
+		const int32 Bucket = Level * SlotsPerLevel + Slot;
+		int32 Index = Heads[Bucket];
+		Heads[Bucket] = Tails[Bucket] = INDEX_NONE;
+		Occupied[Level] &= ~(1ull << Slot);
+
+		while (Index != INDEX_NONE)
+		{
+			const int32 Next = Timers[Index].Next;
+			Link(Index, Time);
+			Index = Next;
+		}
+	}
+}
+
+uint64 FJavascriptTimerWheel::GetNextEventTime() const
+{
+	// the next occupied slot within the current rotation of level 0, or the start of the next rotation
+	const uint64 RotationStart = Current & ~(uint64)(SlotsPerLevel - 1);
+	const int32 From = (int32)(Current & (SlotsPerLevel - 1)) + 1;
+	if (From < SlotsPerLevel)
+	{
+		const uint64 Pending = Occupied[0] & (~0ull << From);
+		if (Pending)
+		{
+			return RotationStart + CountTrailingZeros64(Pending);
+		}
+	}
+	return RotationStart + SlotsPerLevel;
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
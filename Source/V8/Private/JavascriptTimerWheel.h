@@ -0,0 +1,70 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Script timers (setTimeout, setInterval, setImmediate) of a context, kept in a hierarchical timer wheel
+// of millisecond resolution. Adding and removing a timer costs O(1), advancing costs nothing while no timer is due.
+// Timers due at the same millisecond fire in the order they were added.
+class FJavascriptTimerWheel
+{
+public:
+	FJavascriptTimerWheel();
+	~FJavascriptTimerWheel();
+
+	// Arguments is an array of extra arguments or JS_INVALID_REFERENCE, a zero interval makes a one shot timer.
+	// Returns the handle scripts use to cancel the timer, never zero.
+	int32 Add(JsValueRef Callback, JsValueRef Arguments, uint32 DelayInMs, uint32 IntervalInMs);
+
+	// Unknown or already fired handles are ignored
+	void Remove(int32 Handle);
+
+	// Fires every timer due by now, returns the number of timers fired.
+	// Intervals fire at most once per call, missed periods are skipped rather than caught up on.
+	int32 Advance(TFunctionRef<void(JsValueRef Callback, JsValueRef Arguments)> Fire);
+
+	int32 Num() const;
+
+	// Releases pending timers without firing them
+	void Reset();
+
+private:
+	static const int32 SlotBits = 6;
+	static const int32 SlotsPerLevel = 1 << SlotBits;
+	static const int32 NumLevels = 4;
+	static const int32 NumBuckets = NumLevels * SlotsPerLevel;
+	// timers being fired are parked in an extra bucket, so removing them works like any other
+	static const int32 ExpiringBucket = NumBuckets;
+
+	struct FTimer
+	{
+		JsValueRef Callback;
+		JsValueRef Arguments;
+		uint64 Due;
+		uint32 Interval;
+		int32 Handle;
+		int32 Bucket;
+		int32 Prev;
+		int32 Next;
+	};
+
+	static uint64 GetTimeInMs();
+
+	void Link(int32 Index, uint64 Base);
+	void Unlink(int32 Index);
+	void Release(int32 Index);
+	void Cascade(uint64 Time);
+	uint64 GetNextEventTime() const;
+
+	TSparseArray<FTimer> Timers;
+	TMap<int32, int32> Handles;
+	int32 Heads[NumBuckets + 1];
+	int32 Tails[NumBuckets + 1];
+	uint64 Occupied[NumLevels];
+
+	// last millisecond processed
+	uint64 Current;
+	int32 NextHandle;
+
+	int32 FiringTimer;
+	bool bFiringTimerRemoved;
+};
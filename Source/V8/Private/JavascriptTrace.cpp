@@ -0,0 +1,220 @@
+#include "JavascriptTrace.h"
+#include "JavascriptJson.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+bool FJavascriptTrace::bEnabled = false;
+
+static TAutoConsoleVariable<int32> CVarTraceBufferSize(
+	TEXT("javascript.Trace.BufferSize"),
+	65536,
+	TEXT("Number of trace events kept per thread, applies to buffers created after the change"));
+
+namespace
+{
+	struct FTraceEvent
+	{
+		const TCHAR* Name;
+		FString Detail;
+		uint64 StartCycles;
+		uint64 EndCycles;
+	};
+
+	struct FTraceBuffer
+	{
+		uint32 ThreadId;
+		TArray<FTraceEvent> Events;
+		int32 Next = 0;
+		bool bWrapped = false;
+
+		// set under BuffersLock; the events are kept until the next Start() or Save()
+		bool bThreadExited = false;
+
+		// only contended while saving
+		FCriticalSection Lock;
+	};
+
+	FCriticalSection BuffersLock;
+	TArray<TUniquePtr<FTraceBuffer>> Buffers;
+
+	// flags the buffer of an exiting thread (eg. background work, workers) so that it can be freed
+	struct FThreadBufferOwner
+	{
+		FTraceBuffer* Buffer = nullptr;
+
+		~FThreadBufferOwner()
+		{
+			if (Buffer)
+			{
+				FScopeLock Scope(&BuffersLock);
+				Buffer->bThreadExited = true;
+			}
+		}
+	};
+	thread_local FThreadBufferOwner ThreadBuffer;
+
+	FTraceBuffer& GetThreadBuffer()
+	{
+		if (!ThreadBuffer.Buffer)
+		{
+			auto Buffer = MakeUnique<FTraceBuffer>();
+			Buffer->ThreadId = FPlatformTLS::GetCurrentThreadId();
+			Buffer->Events.SetNum(FMath::Max(CVarTraceBufferSize.GetValueOnAnyThread(), 1));
+			ThreadBuffer.Buffer = Buffer.Get();
+
+			FScopeLock Scope(&BuffersLock);
+			Buffers.Add(MoveTemp(Buffer));
+		}
+		return *ThreadBuffer.Buffer;
+	}
+
+	// Call with BuffersLock held
+	void FreeExitedThreadBuffers()
+	{
+		Buffers.RemoveAll([](const TUniquePtr<FTraceBuffer>& Buffer) { return Buffer->bThreadExited; });
+	}
+
+	FString GetThreadName(uint32 ThreadId)
+	{
+		if (ThreadId == GGameThreadId)
+		{
+			return TEXT("GameThread");
+		}
+
+		const FString& Name = FThreadManager::Get().GetThreadName(ThreadId);
+		return Name.IsEmpty() ? FString::Printf(TEXT("Thread %u"), ThreadId) : Name;
+	}
+
+	void HandleCommand(const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		const FString Command = Args.Num() ? Args[0] : FString();
+		if (Command == TEXT("start"))
+		{
+			FJavascriptTrace::Start();
+			Ar.Log(TEXT("Javascript trace started"));
+		}
+		else if (Command == TEXT("stop") || Command == TEXT("save"))
+		{
+			if (Command == TEXT("stop"))
+			{
+				FJavascriptTrace::Stop();
+			}
+
+			const FString Filename = Args.Num() > 1
+				? Args[1]
+				: FPaths::ProfilingDir() / TEXT("UnrealJS") / FString::Printf(TEXT("trace-%s.json"), *FDateTime::Now().ToString());
+
+			if (FJavascriptTrace::Save(Filename))
+			{
+				Ar.Logf(TEXT("Javascript trace written to %s"), *Filename);
+			}
+			else
+			{
+				Ar.Logf(TEXT("Failed to write javascript trace to %s"), *Filename);
+			}
+		}
+		else
+		{
+			Ar.Log(TEXT("usage: javascript.Trace start | stop [file] | save [file]"));
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice TraceCommand(
+	TEXT("javascript.Trace"),
+	TEXT("Records script execution into a trace-event timeline. start | stop [file] | save [file]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&HandleCommand));
+
+void FJavascriptTrace::Start()
+{
+	FScopeLock Scope(&BuffersLock);
+	FreeExitedThreadBuffers();
+	for (auto& Buffer : Buffers)
+	{
+		FScopeLock BufferScope(&Buffer->Lock);
+		Buffer->Next = 0;
+		Buffer->bWrapped = false;
+	}
+	bEnabled = true;
+}
+
+void FJavascriptTrace::Stop()
+{
+	bEnabled = false;
+}
+
+void FJavascriptTrace::Record(const TCHAR* Name, FString&& Detail, uint64 StartCycles, uint64 EndCycles)
+{
+	FTraceBuffer& Buffer = GetThreadBuffer();
+	FScopeLock Scope(&Buffer.Lock);
+
+	FTraceEvent& Event = Buffer.Events[Buffer.Next];
+	Event.Name = Name;
+	Event.Detail = MoveTemp(Detail);
+	Event.StartCycles = StartCycles;
+	Event.EndCycles = EndCycles;
+
+	if (++Buffer.Next == Buffer.Events.Num())
+	{
+		Buffer.Next = 0;
+		Buffer.bWrapped = true;
+	}
+}
+
+bool FJavascriptTrace::Save(const FString& Filename)
+{
+	const uint32 ProcessId = FPlatformProcess::GetCurrentProcessId();
+	const double MicrosecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000000.0;
+
+	FString Json = TEXT("{\"traceEvents\":[\n");
+	bool bFirst = true;
+	auto Append = [&](const FString& Event) {
+		if (!bFirst)
+		{
+			Json += TEXT(",\n");
+		}
+		Json += Event;
+		bFirst = false;
+	};
+
+	FScopeLock Scope(&BuffersLock);
+	for (auto& Buffer : Buffers)
+	{
+		FScopeLock BufferScope(&Buffer->Lock);
+
+		Append(FString::Printf(TEXT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}"),
+			ProcessId, Buffer->ThreadId, *FJavascriptJson::Escape(GetThreadName(Buffer->ThreadId))));
+
+		// oldest first
+		const int32 Num = Buffer->bWrapped ? Buffer->Events.Num() : Buffer->Next;
+		const int32 First = Buffer->bWrapped ? Buffer->Next : 0;
+		for (int32 Offset = 0; Offset < Num; ++Offset)
+		{
+			const FTraceEvent& Event = Buffer->Events[(First + Offset) % Buffer->Events.Num()];
+			FString Args;
+			if (!Event.Detail.IsEmpty())
+			{
+				Args = FString::Printf(TEXT(",\"args\":{\"detail\":\"%s\"}"), *FJavascriptJson::Escape(Event.Detail));
+			}
+
+			Append(FString::Printf(TEXT("{\"name\":\"%s\",\"cat\":\"javascript\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u%s}"),
+				Event.Name,
+				Event.StartCycles * MicrosecondsPerCycle,
+				(Event.EndCycles - Event.StartCycles) * MicrosecondsPerCycle,
+				ProcessId, Buffer->ThreadId, *Args));
+		}
+	}
+
+	// their events are in the file now
+	FreeExitedThreadBuffers();
+
+	Json += TEXT("\n]}\n");
+	return FFileHelper::SaveStringToFile(Json, *Filename);
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Timeline of script execution and scheduling, exported as trace-event JSON for chrome://tracing or Perfetto.
+// Every thread records into a ring buffer of its own, the oldest events are overwritten once it is full.
+// Off unless started (javascript.Trace start), a scope costs a flag check then.
+class FJavascriptTrace
+{
+public:
+	static bool IsEnabled() { return bEnabled; }
+
+	static void Start();
+	static void Stop();
+
+	// Writes the recorded events, returns false when the file can't be written
+	static bool Save(const FString& Filename);
+
+	// Name must outlive the recording (a literal), Detail shows up as the event's argument
+	static void Record(const TCHAR* Name, FString&& Detail, uint64 StartCycles, uint64 EndCycles);
+
+private:
+	static bool bEnabled;
+};
+
+// Records a complete event covering its own lifetime
+class FJavascriptTraceScope
+{
+public:
+	explicit FJavascriptTraceScope(const TCHAR* InName)
+		: Name(InName)
+		, StartCycles(FJavascriptTrace::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	FJavascriptTraceScope(const TCHAR* InName, const TCHAR* InDetail)
+		: FJavascriptTraceScope(InName)
+	{
+		if (StartCycles)
+		{
+			Detail = InDetail;
+		}
+	}
+
+	// the object's name is only looked up while tracing
+	FJavascriptTraceScope(const TCHAR* InName, const UObject* Object)
+		: FJavascriptTraceScope(InName)
+	{
+		if (StartCycles && Object)
+		{
+			Detail = Object->GetName();
+		}
+	}
+
+	~FJavascriptTraceScope()
+	{
+		if (StartCycles)
+		{
+			FJavascriptTrace::Record(Name, MoveTemp(Detail), StartCycles, FPlatformTime::Cycles64());
+		}
+	}
+
+private:
+	const TCHAR* Name;
+	FString Detail;
+	uint64 StartCycles;
+};
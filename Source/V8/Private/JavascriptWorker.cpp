@@ -0,0 +1,404 @@
+#include "JavascriptWorker.h"
+#include "Translator.h"
+#include "Helpers.h"
+#include "Exception.h"
+#include "JavascriptSettings.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+static int32 NextWorkerThreadIndex = 0;
+
+FJavascriptWorker::FJavascriptWorker(const FString& InScriptPath, const FString& InSource, const TArray<FString>& InPaths)
+	: ScriptPath(InScriptPath)
+	, Source(InSource)
+	, Paths(InPaths)
+{
+	// settings are only read on the game thread
+	const FJavascriptRuntimeProfile& Profile = GetDefault<UJavascriptSettings>()->DefaultRuntimeProfile;
+	RuntimeAttributes = Profile.GetRuntimeAttributes();
+	MemoryLimitMB = Profile.MemoryLimitMB;
+
+	WakeUp = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FJavascriptWorker::~FJavascriptWorker()
+{
+	Terminate();
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeUp);
+	WakeUp = nullptr;
+}
+
+bool FJavascriptWorker::Start()
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		UE_LOG(Javascript, Warning, TEXT("cannot run worker %s in single threaded environment"), *ScriptPath);
+		return false;
+	}
+
+	FString ThreadName = FString::Printf(TEXT("JavascriptWorker%d"), NextWorkerThreadIndex++);
+	Thread.Reset(FRunnableThread::Create(this, *ThreadName));
+	return Thread.IsValid();
+}
+
+void FJavascriptWorker::Terminate()
+{
+	if (!Thread.IsValid())
+	{
+		return;
+	}
+
+	Stop();
+
+	// also wait for completion
+	Thread->WaitForCompletion();
+	Thread.Reset();
+}
+
+void FJavascriptWorker::Stop()
+{
+	bStopRequested = true;
+
+	{
+		FScopeLock Lock(&RuntimeLock);
+		if (Runtime != JS_INVALID_RUNTIME_HANDLE)
+		{
+			// breaks out of long running script; requires JsRuntimeAttributeAllowScriptInterrupt
+			JsDisableRuntimeExecution(Runtime);
+		}
+	}
+
+	WakeUp->Trigger();
+}
+
+void FJavascriptWorker::PostMessage(const FString& Message)
+{
+	Inbox.Enqueue(Message);
+	WakeUp->Trigger();
+}
+
+bool FJavascriptWorker::Serialize(JsValueRef Value, FString& OutMessage)
+{
+	JsValueRef global = JS_INVALID_REFERENCE;
+	JsCheck(JsGetGlobalObject(&global));
+
+	JsValueRef json = chakra::GetProperty(global, "JSON");
+	JsValueRef stringify = chakra::GetProperty(json, "stringify");
+
+	JsValueRef args[] = { json, Value };
+	JsValueRef result = JS_INVALID_REFERENCE;
+	if (JsCallFunction(stringify, args, ARRAY_COUNT(args), &result) != JsNoError)
+	{
+		return false;
+	}
+
+	OutMessage = chakra::IsString(result) ? chakra::StringFromChakra(result) : FString();
+	return true;
+}
+
+JsValueRef FJavascriptWorker::Deserialize(const FString& Message)
+{
+	if (Message.IsEmpty())
+	{
+		return chakra::Undefined();
+	}
+
+	JsValueRef global = JS_INVALID_REFERENCE;
+	JsCheck(JsGetGlobalObject(&global));
+
+	JsValueRef json = chakra::GetProperty(global, "JSON");
+	JsValueRef parse = chakra::GetProperty(json, "parse");
+
+	JsValueRef args[] = { json, chakra::String(Message) };
+	JsValueRef result = JS_INVALID_REFERENCE;
+	if (JsCallFunction(parse, args, ARRAY_COUNT(args), &result) != JsNoError)
+	{
+		return JS_INVALID_REFERENCE;
+	}
+
+	return result;
+}
+
+uint32 FJavascriptWorker::Run()
+{
+	// Stop() may disable the runtime between any two calls below
+	chakra::SetInterruptibleThread(true);
+
+	JsRuntimeHandle runtime = JS_INVALID_RUNTIME_HANDLE;
+	// nothing calls JsIdle on worker threads
+	const uint32 WorkerAttributes = (RuntimeAttributes & ~JsRuntimeAttributeEnableIdleProcessing) | JsRuntimeAttributeAllowScriptInterrupt;
+	if (JsCreateRuntime((JsRuntimeAttributes)WorkerAttributes, nullptr, &runtime) != JsNoError)
+	{
+		Errors.Enqueue(FString::Printf(TEXT("Failed to create runtime for worker %s"), *ScriptPath));
+		chakra::SetInterruptibleThread(false);
+		bFinished = true;
+		return 1;
+	}
+
+	if (MemoryLimitMB > 0)
+	{
+		JsSetRuntimeMemoryLimit(runtime, (size_t)MemoryLimitMB * 1024 * 1024);
+	}
+
+	{
+		FScopeLock Lock(&RuntimeLock);
+		Runtime = runtime;
+	}
+
+	JsContextRef context = JS_INVALID_REFERENCE;
+	JsCheck(JsCreateContext(runtime, &context));
+	JsCheck(JsSetCurrentContext(context));
+
+	JsCheck(JsSetPromiseContinuationCallback([](JsValueRef Task, void* callbackState) {
+		JsCheck(JsAddRef(Task, nullptr));
+		reinterpret_cast<FJavascriptWorker*>(callbackState)->PromiseTasks.Add(Task);
+	}, this));
+
+	ExposeGlobals();
+
+	if (!bStopRequested && RunScript(Source, ScriptPath))
+	{
+		DrainPromiseTasks();
+
+		while (!bStopRequested)
+		{
+			WakeUp->Wait();
+
+			FString Message;
+			while (!bStopRequested && Inbox.Dequeue(Message))
+			{
+				DispatchMessage(Message);
+				DrainPromiseTasks();
+			}
+		}
+	}
+
+	for (JsValueRef Task : PromiseTasks)
+	{
+		JsRelease(Task, nullptr);
+	}
+	PromiseTasks.Empty();
+
+	{
+		FScopeLock Lock(&RuntimeLock);
+		Runtime = JS_INVALID_RUNTIME_HANDLE;
+	}
+
+	JsSetCurrentContext(JS_INVALID_REFERENCE);
+	chakra::PurgePropertyIDs(runtime);
+	JsDisposeRuntime(runtime);
+
+	chakra::SetInterruptibleThread(false);
+	bFinished = true;
+	return 0;
+}
+
+void FJavascriptWorker::ExposeGlobals()
+{
+	JsValueRef global = JS_INVALID_REFERENCE;
+	JsCheck(JsGetGlobalObject(&global));
+
+	chakra::SetProperty(global, "self", global);
+
+	// postMessage(value)
+	chakra::SetProperty(global, "postMessage", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+		auto Worker = reinterpret_cast<FJavascriptWorker*>(callbackState);
+
+		FString Message;
+		if (Worker->Serialize(argumentCount > 1 ? arguments[1] : chakra::Undefined(), Message))
+		{
+			Worker->Outbox.Enqueue(Message);
+		}
+
+		return chakra::Undefined();
+	}, this));
+
+	// close()
+	chakra::SetProperty(global, "close", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+		auto Worker = reinterpret_cast<FJavascriptWorker*>(callbackState);
+		Worker->bStopRequested = true;
+		Worker->WakeUp->Trigger();
+		return chakra::Undefined();
+	}, this));
+
+	// importScripts(...names)
+	chakra::SetProperty(global, "importScripts", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+		auto Worker = reinterpret_cast<FJavascriptWorker*>(callbackState);
+
+		for (unsigned short Index = 1; Index < argumentCount; ++Index)
+		{
+			FString Path = Worker->ResolveScriptPath(chakra::StringFromChakra(arguments[Index]));
+
+			FString Text;
+			if (Path.IsEmpty() || !FFileHelper::LoadFileToString(Text, *Path))
+			{
+				chakra::Throw(FString::Printf(TEXT("Failed to import script %s"), *chakra::StringFromChakra(arguments[Index])));
+				break;
+			}
+
+			JsValueRef result = JS_INVALID_REFERENCE;
+			if (JsRun(chakra::String(Text), 0, chakra::String(Path), JsParseScriptAttributeNone, &result) != JsNoError)
+			{
+				// leave the exception pending for the caller
+				break;
+			}
+		}
+
+		return chakra::Undefined();
+	}, this));
+
+	// console, logging straight to UE_LOG which is thread safe
+	JsValueRef console = JS_INVALID_REFERENCE;
+	JsCheck(JsCreateObject(&console));
+
+	chakra::SetProperty(console, "log", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+		UE_LOG(Javascript, Log, TEXT("%s"), *chakra::StringFromArgs(arguments, argumentCount, 1));
+		return chakra::Undefined();
+	}));
+
+	chakra::SetProperty(console, "info", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+		UE_LOG(Javascript, Display, TEXT("%s"), *chakra::StringFromArgs(arguments, argumentCount, 1));
+		return chakra::Undefined();
+	}));
+
+	chakra::SetProperty(console, "warn", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+		UE_LOG(Javascript, Warning, TEXT("%s"), *chakra::StringFromArgs(arguments, argumentCount, 1));
+		return chakra::Undefined();
+	}));
+
+	chakra::SetProperty(console, "error", chakra::FunctionTemplate([](JsValueRef callee, bool isConstructCall, JsValueRef *arguments, unsigned short argumentCount, void *callbackState) {
+		UE_LOG(Javascript, Error, TEXT("%s"), *chakra::StringFromArgs(arguments, argumentCount, 1));
+		return chakra::Undefined();
+	}));
+
+	chakra::SetProperty(global, "console", console);
+}
+
+bool FJavascriptWorker::RunScript(const FString& Text, const FString& Path)
+{
+	JsValueRef result = JS_INVALID_REFERENCE;
+	JsErrorCode err = JsRun(chakra::String(Text), 0, chakra::String(Path), JsParseScriptAttributeNone, &result);
+	if (err != JsNoError)
+	{
+		if (!ReportException())
+		{
+			Errors.Enqueue(FString::Printf(TEXT("Failed to run worker script %s (0x%08x)"), *Path, err));
+		}
+		return false;
+	}
+
+	return true;
+}
+
+void FJavascriptWorker::DispatchMessage(const FString& Message)
+{
+	if (bStopRequested)
+	{
+		return;
+	}
+
+	JsValueRef global = JS_INVALID_REFERENCE;
+	JsCheck(JsGetGlobalObject(&global));
+
+	JsValueRef onmessage = chakra::GetProperty(global, "onmessage");
+	if (!chakra::IsFunction(onmessage))
+	{
+		return;
+	}
+
+	JsValueRef data = Deserialize(Message);
+	if (bStopRequested)
+	{
+		return;
+	}
+	if (chakra::IsEmpty(data))
+	{
+		ReportException();
+		return;
+	}
+
+	// same shape as MessageEvent
+	JsValueRef event = JS_INVALID_REFERENCE;
+	JsCheck(JsCreateObject(&event));
+	chakra::SetProperty(event, "data", data);
+
+	JsValueRef args[] = { global, event };
+	JsValueRef result = JS_INVALID_REFERENCE;
+	if (JsCallFunction(onmessage, args, ARRAY_COUNT(args), &result) != JsNoError)
+	{
+		ReportException();
+	}
+}
+
+void FJavascriptWorker::DrainPromiseTasks()
+{
+	JsValueRef global = JS_INVALID_REFERENCE;
+	JsCheck(JsGetGlobalObject(&global));
+
+	while (PromiseTasks.Num() && !bStopRequested)
+	{
+		TArray<JsValueRef> Tasks = MoveTemp(PromiseTasks);
+		for (JsValueRef Task : Tasks)
+		{
+			JsValueRef result = JS_INVALID_REFERENCE;
+			if (JsCallFunction(Task, &global, 1, &result) != JsNoError)
+			{
+				ReportException();
+			}
+
+			JsRelease(Task, nullptr);
+		}
+	}
+}
+
+bool FJavascriptWorker::ReportException()
+{
+	bool hasException = false;
+	if (JsHasException(&hasException) != JsNoError || !hasException)
+	{
+		return false;
+	}
+
+	JsValueRef exception = JS_INVALID_REFERENCE;
+	JsCheck(JsGetAndClearException(&exception));
+
+	// terminated from outside; the runtime is disabled and the exception is just the interruption
+	if (!bStopRequested)
+	{
+		Errors.Enqueue(FV8Exception::Report(exception));
+	}
+	return true;
+}
+
+FString FJavascriptWorker::ResolveScriptPath(const FString& Name) const
+{
+	if (FPaths::FileExists(Name))
+	{
+		return Name;
+	}
+
+	// relative to the worker script first, then the context's search paths
+	FString Relative = FPaths::GetPath(ScriptPath) / Name;
+	if (FPaths::FileExists(Relative))
+	{
+		return Relative;
+	}
+
+	for (const auto& Path : Paths)
+	{
+		FString FullPath = Path / Name;
+		if (FPaths::FileExists(FullPath))
+		{
+			return FullPath;
+		}
+	}
+
+	return FString();
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "V8PCH.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+
+// A script running in its own runtime on its own thread.
+// Only plain data crosses the boundary : messages are JSON strings queued in both directions,
+// the owning context pumps the outbound queue from its ticker.
+class FJavascriptWorker : public FRunnable
+{
+public:
+	FJavascriptWorker(const FString& InScriptPath, const FString& InSource, const TArray<FString>& InPaths);
+	virtual ~FJavascriptWorker();
+
+	bool Start();
+
+	// Interrupts running script and joins the thread
+	void Terminate();
+
+	// game thread -> worker
+	void PostMessage(const FString& Message);
+
+	// worker -> game thread
+	bool PopMessage(FString& OutMessage) { return Outbox.Dequeue(OutMessage); }
+	bool PopError(FString& OutError) { return Errors.Dequeue(OutError); }
+
+	// The script called close() or failed to start; queued messages may still be pending
+	bool IsFinished() const { return bFinished; }
+
+	const FString& GetScriptPath() const { return ScriptPath; }
+
+	// Messages are JSON strings; an empty string stands for undefined.
+	// Serialize leaves the exception pending when the value cannot be cloned (eg. cyclic).
+	static bool Serialize(JsValueRef Value, FString& OutMessage);
+	static JsValueRef Deserialize(const FString& Message);
+
+	// Begin FRunnable interface.
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// End FRunnable interface.
+
+private:
+	void ExposeGlobals();
+	bool RunScript(const FString& Source, const FString& Path);
+	void DispatchMessage(const FString& Message);
+	void DrainPromiseTasks();
+	bool ReportException();
+	FString ResolveScriptPath(const FString& Name) const;
+
+	FString ScriptPath;
+	FString Source;
+	TArray<FString> Paths;
+
+	// from the default runtime profile
+	uint32 RuntimeAttributes{ 0 };
+	int32 MemoryLimitMB{ 0 };
+
+	TQueue<FString, EQueueMode::Spsc> Inbox;
+	TQueue<FString, EQueueMode::Spsc> Outbox;
+	TQueue<FString, EQueueMode::Spsc> Errors;
+
+	FEvent* WakeUp{ nullptr };
+	FThreadSafeBool bStopRequested;
+	FThreadSafeBool bFinished;
+	TUniquePtr<FRunnableThread> Thread;
+
+	// published by the worker thread so that Terminate can interrupt it
+	FCriticalSection RuntimeLock;
+	JsRuntimeHandle Runtime{ JS_INVALID_RUNTIME_HANDLE };
+
+	// only touched on the worker thread
+	TArray<JsValueRef> PromiseTasks;
+};
@@ -0,0 +1,200 @@
+#include "MathStructs.h"
+#include "JavascriptContext_Private.h"
+#include "Translator.h"
+#include "Helpers.h"
+#include "StructMemoryInstance.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+namespace
+{
+	struct FFloatField
+	{
+		const char* Name;
+		int32 Offset;
+	};
+
+	struct FMathStructLayout
+	{
+		UScriptStruct* Struct;
+		TArray<FFloatField> Fields;
+	};
+
+	#define MATH_STRUCT_FIELD(Type, Field) FFloatField{ #Field, (int32)STRUCT_OFFSET(Type, Field) }
+
+	const TArray<FMathStructLayout>& GetLayouts()
+	{
+		static const TArray<FMathStructLayout> Layouts = {
+			{ TBaseStructure<FVector>::Get(), { MATH_STRUCT_FIELD(FVector, X), MATH_STRUCT_FIELD(FVector, Y), MATH_STRUCT_FIELD(FVector, Z) } },
+			{ TBaseStructure<FRotator>::Get(), { MATH_STRUCT_FIELD(FRotator, Pitch), MATH_STRUCT_FIELD(FRotator, Yaw), MATH_STRUCT_FIELD(FRotator, Roll) } },
+			{ TBaseStructure<FVector2D>::Get(), { MATH_STRUCT_FIELD(FVector2D, X), MATH_STRUCT_FIELD(FVector2D, Y) } },
+			{ TBaseStructure<FQuat>::Get(), { MATH_STRUCT_FIELD(FQuat, X), MATH_STRUCT_FIELD(FQuat, Y), MATH_STRUCT_FIELD(FQuat, Z), MATH_STRUCT_FIELD(FQuat, W) } },
+			{ TBaseStructure<FLinearColor>::Get(), { MATH_STRUCT_FIELD(FLinearColor, R), MATH_STRUCT_FIELD(FLinearColor, G), MATH_STRUCT_FIELD(FLinearColor, B), MATH_STRUCT_FIELD(FLinearColor, A) } },
+			{ TBaseStructure<FVector4>::Get(), { MATH_STRUCT_FIELD(FVector4, X), MATH_STRUCT_FIELD(FVector4, Y), MATH_STRUCT_FIELD(FVector4, Z), MATH_STRUCT_FIELD(FVector4, W) } }
+		};
+		return Layouts;
+	}
+
+	#undef MATH_STRUCT_FIELD
+
+	const FMathStructLayout* FindLayout(UScriptStruct* Struct)
+	{
+		for (const FMathStructLayout& Layout : GetLayouts())
+		{
+			if (Layout.Struct == Struct)
+			{
+				return &Layout;
+			}
+		}
+		return nullptr;
+	}
+
+	const FMathStructLayout& GetLayout(UScriptStruct* Struct)
+	{
+		const FMathStructLayout* Layout = FindLayout(Struct);
+		check(Layout);
+		return *Layout;
+	}
+
+	// Packed components out of an array or a typed array of exactly Num elements
+	bool ReadComponents(JsValueRef Value, JsValueType Type, double* Out, int32 Num)
+	{
+		if (Type == JsTypedArray)
+		{
+			ChakraBytePtr Storage = nullptr;
+			unsigned int Length = 0;
+			JsTypedArrayType ArrayType;
+			int ElementSize = 0;
+			JsCheck(JsGetTypedArrayStorage(Value, &Storage, &Length, &ArrayType, &ElementSize));
+			if (ElementSize <= 0 || (int32)(Length / ElementSize) != Num)
+			{
+				return false;
+			}
+
+			if (ArrayType == JsArrayTypeFloat64)
+			{
+				FMemory::Memcpy(Out, Storage, Num * sizeof(double));
+				return true;
+			}
+			else if (ArrayType == JsArrayTypeFloat32)
+			{
+				const float* Floats = reinterpret_cast<const float*>(Storage);
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					Out[Index] = Floats[Index];
+				}
+				return true;
+			}
+		}
+		else if (Type != JsArray || chakra::Length(Value) != Num)
+		{
+			return false;
+		}
+
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Out[Index] = chakra::DoubleFrom(chakra::GetIndex(Value, Index));
+		}
+		return true;
+	}
+
+	bool ReadFloatStruct(JsValueRef Value, const FMathStructLayout& Layout, uint8* Dest)
+	{
+		const JsValueType Type = chakra::GetType(Value);
+		if (Type == JsArray || Type == JsTypedArray)
+		{
+			double Packed[4];
+			if (!ReadComponents(Value, Type, Packed, Layout.Fields.Num()))
+			{
+				return false;
+			}
+
+			for (int32 Index = 0; Index < Layout.Fields.Num(); ++Index)
+			{
+				*reinterpret_cast<float*>(Dest + Layout.Fields[Index].Offset) = (float)Packed[Index];
+			}
+			return true;
+		}
+		else if (Type != JsObject)
+		{
+			return false;
+		}
+
+		// an instance of the very same struct is copied as is
+		auto Instance = FStructMemoryInstance::FromChakra(Value);
+		if (Instance && Instance->Struct == Layout.Struct)
+		{
+			if (uint8* Memory = Instance->GetMemory())
+			{
+				Layout.Struct->CopyScriptStruct(Dest, Memory);
+			}
+			return true;
+		}
+
+		// missing fields keep their value, like any other struct read off an object
+		for (const FFloatField& Field : Layout.Fields)
+		{
+			JsValueRef FieldValue = chakra::GetProperty(Value, Field.Name);
+			if (!chakra::IsEmpty(FieldValue) && !chakra::IsUndefined(FieldValue))
+			{
+				*reinterpret_cast<float*>(Dest + Field.Offset) = (float)chakra::DoubleFrom(FieldValue);
+			}
+		}
+		return true;
+	}
+
+	bool ReadTransform(JsValueRef Value, FTransform& Transform)
+	{
+		const JsValueType Type = chakra::GetType(Value);
+		if (Type == JsArray || Type == JsTypedArray)
+		{
+			double Packed[10];
+			if (!ReadComponents(Value, Type, Packed, 10))
+			{
+				return false;
+			}
+
+			Transform.SetComponents(
+				FQuat(Packed[0], Packed[1], Packed[2], Packed[3]),
+				FVector(Packed[4], Packed[5], Packed[6]),
+				FVector(Packed[7], Packed[8], Packed[9]));
+			return true;
+		}
+		else if (Type != JsObject)
+		{
+			return false;
+		}
+
+		// the vectorized layout is private, go through the accessors
+		FQuat Rotation = Transform.GetRotation();
+		FVector Translation = Transform.GetTranslation();
+		FVector Scale3D = Transform.GetScale3D();
+
+		auto ReadComponent = [&](const char* Name, UScriptStruct* Struct, uint8* Dest) {
+			JsValueRef FieldValue = chakra::GetProperty(Value, Name);
+			if (!chakra::IsEmpty(FieldValue) && !chakra::IsUndefined(FieldValue))
+			{
+				ReadFloatStruct(FieldValue, GetLayout(Struct), Dest);
+			}
+		};
+		ReadComponent("Rotation", TBaseStructure<FQuat>::Get(), (uint8*)&Rotation);
+		ReadComponent("Translation", TBaseStructure<FVector>::Get(), (uint8*)&Translation);
+		ReadComponent("Scale3D", TBaseStructure<FVector>::Get(), (uint8*)&Scale3D);
+
+		Transform.SetComponents(Rotation, Translation, Scale3D);
+		return true;
+	}
+}
+
+bool FJavascriptMathStructs::Read(JsValueRef Value, UScriptStruct* Struct, uint8* Dest)
+{
+	if (Struct == TBaseStructure<FTransform>::Get())
+	{
+		return ReadTransform(Value, *reinterpret_cast<FTransform*>(Dest));
+	}
+
+	const FMathStructLayout* Layout = FindLayout(Struct);
+	return Layout && ReadFloatStruct(Value, *Layout, Dest);
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Reflection-free conversion from script values into the core math structs
+// (FVector, FVector2D, FVector4, FRotator, FQuat, FLinearColor and FTransform).
+// Accepts plain objects with the usual field names, and packed arrays or typed arrays
+// holding the components in declaration order (FTransform : rotation xyzw, translation xyz, scale xyz).
+struct FJavascriptMathStructs
+{
+	// False when Struct is not a math struct or Value has the wrong shape, Dest is left untouched then
+	static bool Read(JsValueRef Value, UScriptStruct* Struct, uint8* Dest);
+};
@@ -0,0 +1,141 @@
+#include "ModuleCache.h"
+#include "Translator.h"
+#include "Helpers.h"
+#include "JavascriptStats.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/Crc.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+static TAutoConsoleVariable<int32> CVarModuleCache(
+	TEXT("javascript.ModuleCache"),
+	1,
+	TEXT("Cache serialized require()'d modules on disk (0 = off, 1 = on)"));
+
+namespace
+{
+	FString GetCacheKey(const FString& Source)
+	{
+		// bytecode layout depends on chakra version and pointer size
+		static const FString Salt = FString::Printf(TEXT("%s|%d.%d.%d|%d"),
+			*FEngineVersion::Current().ToString(),
+			CHAKRA_CORE_MAJOR_VERSION, CHAKRA_CORE_MINOR_VERSION, CHAKRA_CORE_PATCH_VERSION,
+			(int32)sizeof(void*));
+
+		FSHA1 Sha;
+		Sha.Update((const uint8*)*Salt, Salt.Len() * sizeof(TCHAR));
+		Sha.Update((const uint8*)*Source, Source.Len() * sizeof(TCHAR));
+		Sha.Final();
+
+		FSHAHash Hash;
+		Sha.GetHash(Hash.Hash);
+		return Hash.ToString();
+	}
+
+	FString GetCachePath(const FString& Source)
+	{
+		return FJavascriptModuleCache::GetCacheDir() / GetCacheKey(Source) + TEXT(".jsc");
+	}
+
+	// JsRunSerialized trusts its input, so truncated or torn files must never reach it
+	struct FCacheHeader
+	{
+		static const uint32 ExpectedMagic = 0x4A534331; // 'JSC1'
+
+		uint32 Magic;
+		uint32 Size;
+		uint32 Crc;
+	};
+}
+
+bool FJavascriptModuleCache::IsEnabled()
+{
+	return CVarModuleCache.GetValueOnGameThread() != 0;
+}
+
+FString FJavascriptModuleCache::GetCacheDir()
+{
+	return FPaths::ProjectIntermediateDir() / TEXT("Javascript") / TEXT("ModuleCache");
+}
+
+JsValueRef FJavascriptModuleCache::Load(const FString& Source)
+{
+	const FString Path = GetCachePath(Source);
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent) || Data.Num() == 0)
+	{
+		INC_DWORD_STAT(STAT_JavascriptModuleCacheMiss);
+		return JS_INVALID_REFERENCE;
+	}
+
+	FCacheHeader Header;
+	const int32 PayloadSize = Data.Num() - (int32)sizeof(FCacheHeader);
+	if (PayloadSize > 0)
+	{
+		FMemory::Memcpy(&Header, Data.GetData(), sizeof(FCacheHeader));
+	}
+
+	const uint8* Payload = Data.GetData() + sizeof(FCacheHeader);
+	if (PayloadSize <= 0 || Header.Magic != FCacheHeader::ExpectedMagic || Header.Size != (uint32)PayloadSize || Header.Crc != FCrc::MemCrc32(Payload, PayloadSize))
+	{
+		UE_LOG(Javascript, Log, TEXT("Ignoring corrupted module cache %s"), *Path);
+		IFileManager::Get().Delete(*Path, false, false, true);
+		INC_DWORD_STAT(STAT_JavascriptModuleCacheMiss);
+		return JS_INVALID_REFERENCE;
+	}
+
+	// chakra keeps the buffer alive as long as the script needs it
+	JsValueRef Buffer = JS_INVALID_REFERENCE;
+	JsCheck(JsCreateArrayBuffer(PayloadSize, &Buffer));
+
+	ChakraBytePtr Storage = nullptr;
+	unsigned int Length = 0;
+	JsCheck(JsGetArrayBufferStorage(Buffer, &Storage, &Length));
+	FMemory::Memcpy(Storage, Payload, Length);
+
+	INC_DWORD_STAT(STAT_JavascriptModuleCacheHit);
+	return Buffer;
+}
+
+void FJavascriptModuleCache::Save(const FString& Source)
+{
+	JsValueRef Buffer = JS_INVALID_REFERENCE;
+	if (JsSerialize(chakra::String(Source), &Buffer, JsParseScriptAttributeNone) != JsNoError)
+	{
+		// leave no pending exception behind, the module itself already compiled fine
+		JsValueRef Exception = JS_INVALID_REFERENCE;
+		JsGetAndClearException(&Exception);
+		return;
+	}
+
+	ChakraBytePtr Storage = nullptr;
+	unsigned int Length = 0;
+	JsCheck(JsGetArrayBufferStorage(Buffer, &Storage, &Length));
+
+	FCacheHeader Header;
+	Header.Magic = FCacheHeader::ExpectedMagic;
+	Header.Size = Length;
+	Header.Crc = FCrc::MemCrc32(Storage, Length);
+
+	TArray<uint8> Data;
+	Data.Reserve(sizeof(FCacheHeader) + Length);
+	Data.Append((const uint8*)&Header, sizeof(FCacheHeader));
+	Data.Append(Storage, Length);
+
+	// other processes (editor, game, commandlets) share the directory; readers only ever see complete files
+	const FString Path = GetCachePath(Source);
+	const FString TempPath = FPaths::CreateTempFilename(*GetCacheDir(), TEXT("Module"), TEXT(".tmp"));
+	if (!FFileHelper::SaveArrayToFile(Data, *TempPath) || !IFileManager::Get().Move(*Path, *TempPath, true, true, false, true))
+	{
+		UE_LOG(Javascript, Warning, TEXT("Failed to write module cache %s"), *Path);
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+	}
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
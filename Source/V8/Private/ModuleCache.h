@@ -0,0 +1,18 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// On-disk cache of serialized scripts, keyed by source hash and engine/chakra version.
+// Entries carry a size/CRC header checked before chakra sees the bytes, and are written to a temp file then renamed.
+struct FJavascriptModuleCache
+{
+	static bool IsEnabled();
+
+	// Loads serialized script for Source into a new ArrayBuffer, JS_INVALID_REFERENCE if not cached
+	static JsValueRef Load(const FString& Source);
+
+	// Serializes Source and writes it to the cache
+	static void Save(const FString& Source);
+
+	static FString GetCacheDir();
+};
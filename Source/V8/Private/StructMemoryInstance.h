@@ -1,5 +1,7 @@
 #pragma once
 
+#include "StructMemoryPool.h"
+
 struct FObjectPropertyOwner : IPropertyOwner
 {
 	UObject* Object;
@@ -53,7 +55,9 @@ struct FStructMemoryInstance
 
 		if (Owner == EPropertyOwner::None)
 		{
-			Buffer.AddUninitialized(Struct->GetStructureSize());
+			Buffer = CanUseInlineBuffer(Struct)
+				? reinterpret_cast<uint8*>(this) + GetInlineBufferOffset()
+				: (uint8*)FMemory::Malloc(Struct->GetStructureSize(), Struct->GetMinAlignment());
 			Struct->InitializeStruct(GetMemory());
 
 			if (Source)
@@ -66,10 +70,32 @@ struct FStructMemoryInstance
 
 	~FStructMemoryInstance()
 	{
-		if (Owner == EPropertyOwner::None)
+		Orphan();
+		FreeBuffer();
+	}
+
+	// Struct type is going away, drop the memory while the wrapper may still be around.
+	// Typed arrays aliasing the buffer keep it allocated (not initialized) until they are finalized.
+	void Orphan()
+	{
+		if (bOrphaned)
 		{
-			Struct->DestroyStruct(GetMemory());
+			return;
+		}
+
+		if (Owner == EPropertyOwner::None && Buffer)
+		{
+			Struct->DestroyStruct(Buffer);
+			if (NumExternalViews == 0)
+			{
+				FreeBuffer();
+			}
 		}
+
+		bOrphaned = true;
+		Source = nullptr;
+		Parent.Reset();
+		Object.Reset();
 	}
 
 	// Struct 
@@ -87,14 +113,30 @@ struct FStructMemoryInstance
 	// Parent instance
 	TSharedPtr<FStructMemoryInstance> Parent;
 
-	// Independent memory buffer
-	TArray<uint8, TAlignedHeapAllocator<16>> Buffer;
+	// Independent memory, inline behind the instance unless the struct needs more alignment
+	uint8* Buffer{ nullptr };
+
+	// Name the pool counts this instance under, and the size of its pooled block
+	FName PoolName;
+	uint32 PoolBlockSize{ 0 };
+
+	// Slot in its context's instance list
+	int32 ContextIndex{ INDEX_NONE };
+
+	// External ArrayBuffers aliasing the buffer
+	int32 NumExternalViews{ 0 };
+
+	bool bOrphaned{ false };
 
 	uint8* GetMemory()
 	{
-		if (Owner == EPropertyOwner::None)
+		if (bOrphaned)
 		{
-			return Buffer.GetData();
+			return nullptr;
+		}
+		else if (Owner == EPropertyOwner::None)
+		{
+			return Buffer;
 		}
 		else if (Object.IsValid())
 		{
@@ -110,14 +152,63 @@ struct FStructMemoryInstance
 		}
 	}
 
+	// Bytes kept alive by this instance, its pooled block and separately allocated memory
+	SIZE_T GetRetainedSize() const
+	{
+		SIZE_T Size = PoolBlockSize;
+		if (Buffer && Buffer != reinterpret_cast<const uint8*>(this) + GetInlineBufferOffset())
+		{
+			Size += Struct->GetStructureSize();
+		}
+		return Size;
+	}
+
 	static TSharedRef<FStructMemoryInstance> Create(UScriptStruct* Struct, const IPropertyOwner& InOwner, void* Source = nullptr)
 	{
-		return TSharedRef<FStructMemoryInstance>(new FStructMemoryInstance(Struct, InOwner, Source));
+		SIZE_T BlockSize = sizeof(FStructMemoryInstance);
+		if (InOwner.Owner == EPropertyOwner::None && CanUseInlineBuffer(Struct))
+		{
+			BlockSize = GetInlineBufferOffset() + Struct->GetStructureSize();
+		}
+
+		const FName PoolName = Struct->GetFName();
+		void* Block = FStructMemoryPool::Allocate(PoolName, BlockSize);
+		auto Instance = new (Block) FStructMemoryInstance(Struct, InOwner, Source);
+		Instance->PoolName = PoolName;
+		Instance->PoolBlockSize = (uint32)BlockSize;
+
+		return MakeShareable(Instance, [](FStructMemoryInstance* Instance) {
+			const FName PoolName = Instance->PoolName;
+			const SIZE_T BlockSize = Instance->PoolBlockSize;
+			Instance->~FStructMemoryInstance();
+			FStructMemoryPool::Free(PoolName, Instance, BlockSize);
+		});
 	}
 
 	static FStructMemoryInstance* FromChakra(JsValueRef Value)
 	{
-		auto Memory = RawMemoryFromChakra(Value);
-		return reinterpret_cast<FStructMemoryInstance*>(Memory);
-	}	
+		auto Handle = chakra::NativeHandleFromChakra(Value);
+		auto Instance = Handle && Handle->Type == ENativeHandleType::Struct ? reinterpret_cast<FStructMemoryInstance*>(Handle->Ptr) : nullptr;
+		return Instance && !Instance->bOrphaned ? Instance : nullptr;
+	}
+
+private:
+	void FreeBuffer()
+	{
+		if (Buffer && Buffer != reinterpret_cast<uint8*>(this) + GetInlineBufferOffset())
+		{
+			FMemory::Free(Buffer);
+		}
+		Buffer = nullptr;
+	}
+
+	static SIZE_T GetInlineBufferOffset()
+	{
+		return Align(sizeof(FStructMemoryInstance), FStructMemoryPool::BlockAlignment);
+	}
+
+	static bool CanUseInlineBuffer(UScriptStruct* Struct)
+	{
+		return Struct->GetMinAlignment() <= (int32)FStructMemoryPool::BlockAlignment;
+	}
 };
\ No newline at end of file
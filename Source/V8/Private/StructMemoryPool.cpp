@@ -0,0 +1,168 @@
+#include "StructMemoryPool.h"
+#include "JavascriptStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+namespace
+{
+	// bins go up in BlockAlignment steps, bigger blocks bypass the pool
+	const SIZE_T MaxPooledSize = 512;
+	const int32 NumBins = MaxPooledSize / FStructMemoryPool::BlockAlignment;
+	const int32 BlocksPerSlab = 64;
+
+	struct FFreeBlock
+	{
+		FFreeBlock* Next;
+	};
+
+	struct FBin
+	{
+		FFreeBlock* FreeList = nullptr;
+		TArray<void*> Slabs;
+		int32 NumUsed = 0;
+	};
+
+	struct FStructCounters
+	{
+		int32 Live = 0;
+		int32 Peak = 0;
+		uint64 Allocations = 0;
+		uint64 Reused = 0;
+	};
+
+	// uncontended unless background work runs script
+	FCriticalSection PoolLock;
+
+	FBin Bins[NumBins];
+	TMap<FName, FStructCounters> Counters;
+
+	int32 GetBinIndex(SIZE_T Size)
+	{
+		return (int32)((Size - 1) / FStructMemoryPool::BlockAlignment);
+	}
+
+	void Refill(FBin& Bin, SIZE_T BlockSize)
+	{
+		const SIZE_T SlabSize = BlockSize * BlocksPerSlab;
+		uint8* Slab = (uint8*)FMemory::Malloc(SlabSize, FStructMemoryPool::BlockAlignment);
+		Bin.Slabs.Add(Slab);
+		INC_MEMORY_STAT_BY(STAT_JavascriptStructPool, SlabSize);
+
+		for (int32 Index = BlocksPerSlab - 1; Index >= 0; --Index)
+		{
+			FFreeBlock* Block = reinterpret_cast<FFreeBlock*>(Slab + Index * BlockSize);
+			Block->Next = Bin.FreeList;
+			Bin.FreeList = Block;
+		}
+	}
+}
+
+static FAutoConsoleCommandWithOutputDevice StructPoolStatsCommand(
+	TEXT("javascript.StructPoolStats"),
+	TEXT("Lists struct instances created for script, per struct type"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FStructMemoryPool::DumpStats));
+
+void* FStructMemoryPool::Allocate(FName StructName, SIZE_T Size)
+{
+	check(Size > 0);
+
+	FScopeLock Lock(&PoolLock);
+
+	FStructCounters& StructCounters = Counters.FindOrAdd(StructName);
+	StructCounters.Allocations++;
+	StructCounters.Live++;
+	StructCounters.Peak = FMath::Max(StructCounters.Peak, StructCounters.Live);
+	INC_DWORD_STAT(STAT_JavascriptStructInstances);
+
+	if (Size > MaxPooledSize)
+	{
+		return FMemory::Malloc(Size, BlockAlignment);
+	}
+
+	const int32 BinIndex = GetBinIndex(Size);
+	FBin& Bin = Bins[BinIndex];
+	if (Bin.FreeList)
+	{
+		StructCounters.Reused++;
+	}
+	else
+	{
+		Refill(Bin, (BinIndex + 1) * BlockAlignment);
+	}
+
+	FFreeBlock* Block = Bin.FreeList;
+	Bin.FreeList = Block->Next;
+	Bin.NumUsed++;
+	return Block;
+}
+
+void FStructMemoryPool::Free(FName StructName, void* Block, SIZE_T Size)
+{
+	FScopeLock Lock(&PoolLock);
+
+	if (FStructCounters* StructCounters = Counters.Find(StructName))
+	{
+		StructCounters->Live--;
+	}
+	DEC_DWORD_STAT(STAT_JavascriptStructInstances);
+
+	if (Size > MaxPooledSize)
+	{
+		FMemory::Free(Block);
+		return;
+	}
+
+	FBin& Bin = Bins[GetBinIndex(Size)];
+	FFreeBlock* FreeBlock = reinterpret_cast<FFreeBlock*>(Block);
+	FreeBlock->Next = Bin.FreeList;
+	Bin.FreeList = FreeBlock;
+	Bin.NumUsed--;
+}
+
+void FStructMemoryPool::Shutdown()
+{
+	FScopeLock Lock(&PoolLock);
+
+	for (int32 BinIndex = 0; BinIndex < NumBins; ++BinIndex)
+	{
+		FBin& Bin = Bins[BinIndex];
+		if (Bin.NumUsed > 0)
+		{
+			UE_LOG(Javascript, Warning, TEXT("%d struct instances of %d bytes still alive, keeping their pool"), Bin.NumUsed, (int32)((BinIndex + 1) * BlockAlignment));
+			continue;
+		}
+
+		for (void* Slab : Bin.Slabs)
+		{
+			FMemory::Free(Slab);
+		}
+		DEC_MEMORY_STAT_BY(STAT_JavascriptStructPool, Bin.Slabs.Num() * BlocksPerSlab * (BinIndex + 1) * BlockAlignment);
+		Bin.Slabs.Empty();
+		Bin.FreeList = nullptr;
+	}
+}
+
+void FStructMemoryPool::DumpStats(FOutputDevice& Ar)
+{
+	FScopeLock Lock(&PoolLock);
+
+	Counters.ValueSort([](const FStructCounters& A, const FStructCounters& B) { return A.Allocations > B.Allocations; });
+
+	Ar.Logf(TEXT("%-40s %10s %10s %12s %12s"), TEXT("Struct"), TEXT("Live"), TEXT("Peak"), TEXT("Allocations"), TEXT("Reused"));
+	for (const auto& Pair : Counters)
+	{
+		const FStructCounters& StructCounters = Pair.Value;
+		Ar.Logf(TEXT("%-40s %10d %10d %12llu %12llu"), *Pair.Key.ToString(), StructCounters.Live, StructCounters.Peak, StructCounters.Allocations, StructCounters.Reused);
+	}
+
+	SIZE_T PooledBytes = 0;
+	for (int32 BinIndex = 0; BinIndex < NumBins; ++BinIndex)
+	{
+		PooledBytes += Bins[BinIndex].Slabs.Num() * BlocksPerSlab * (BinIndex + 1) * BlockAlignment;
+	}
+	Ar.Logf(TEXT("Pooled memory: %llu bytes"), (uint64)PooledBytes);
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Size-binned slab allocator for struct instances crossing into script.
+// Freed blocks are kept on per-bin free lists and reused, slabs live until shutdown.
+// Mostly used from the game thread, but background work (UJavascriptComponent::DoInBackground) runs script
+// on other threads and instances may be freed wherever their wrapper is finalized, so access is locked.
+struct FStructMemoryPool
+{
+	// Every block is aligned to this, struct memory needing more is allocated separately
+	static const SIZE_T BlockAlignment = 16;
+
+	static void* Allocate(FName StructName, SIZE_T Size);
+	static void Free(FName StructName, void* Block, SIZE_T Size);
+
+	// Releases the slabs, only when no block is in use anymore
+	static void Shutdown();
+
+	static void DumpStats(FOutputDevice& Ar);
+};
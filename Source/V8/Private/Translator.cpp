@@ -1,15 +1,256 @@
 #include "Translator.h"
 #include "Helpers.h"
 #include "V8PCH.h"
+#include "Engine/UserDefinedStruct.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/Atomic.h"
+
+FString PropertyNameToString(UProperty* Property)
+{
+	auto Struct = Property->GetOwnerStruct();
+	auto name = Property->GetFName();
+	if (Struct)
+	{
+		if (auto s = Cast<UUserDefinedStruct>(Struct))
+		{
+			return s->PropertyNameToDisplayName(name);
+		}
+	}
+	return name.ToString();
+}
+
+namespace
+{
+	// JS property names are case sensitive, unlike the default FString key funcs
+	struct FCaseSensitivePropertyIdKeyFuncs : BaseKeyFuncs<TPair<FString, JsPropertyIdRef>, FString, false>
+	{
+		static const FString& GetSetKey(const TPair<FString, JsPropertyIdRef>& Element) { return Element.Key; }
+		static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+
+	struct FInternedLiteral
+	{
+		TArray<ANSICHAR> Text;
+		JsPropertyIdRef PropertyId;
+	};
+
+	struct FInternedProperty
+	{
+		FName Name;
+		UStruct* Owner;
+		JsPropertyIdRef PropertyId;
+	};
+
+	// Interned ids are add-ref'ed once and live until the runtime goes away
+	struct FPropertyIdTable
+	{
+		// keep names built from arbitrary script data from growing the table without bound
+		static const int32 MaxEntries = 65536;
+
+		TMap<FString, JsPropertyIdRef, FDefaultSetAllocator, FCaseSensitivePropertyIdKeyFuncs> Strings;
+		TMap<const char*, FInternedLiteral> Literals;
+		TMap<UProperty*, FInternedProperty> Properties;
+
+		// private symbol the native handle of wrappers is stored under
+		JsPropertyIdRef NativeHandle = JS_INVALID_REFERENCE;
+	};
+
+	FCriticalSection PropertyIdTablesLock;
+	TMap<JsRuntimeHandle, TSharedPtr<FPropertyIdTable>> PropertyIdTables;
+	TAtomic<uint32> PropertyIdTablesGeneration(0);
+
+	JsPropertyIdRef CreatePropertyId(const char* ID, size_t Length, bool bIntern)
+	{
+		JsPropertyIdRef PropID = JS_INVALID_REFERENCE;
+		JsCheck(JsCreatePropertyId(ID, Length, &PropID));
+		if (bIntern)
+		{
+			JsCheck(JsAddRef(PropID, nullptr));
+		}
+		return PropID;
+	}
+
+	FPropertyIdTable* GetPropertyIdTable()
+	{
+		JsContextRef Context = JS_INVALID_REFERENCE;
+		JsRuntimeHandle Runtime = JS_INVALID_RUNTIME_HANDLE;
+		if (JsGetCurrentContext(&Context) != JsNoError || Context == JS_INVALID_REFERENCE || JsGetRuntime(Context, &Runtime) != JsNoError)
+		{
+			return nullptr;
+		}
+
+		// a runtime is used by one thread at a time, so remember the last table per thread
+		static thread_local JsRuntimeHandle LastRuntime = JS_INVALID_RUNTIME_HANDLE;
+		static thread_local FPropertyIdTable* LastTable = nullptr;
+		static thread_local uint32 LastGeneration = 0;
+
+		const uint32 Generation = PropertyIdTablesGeneration.Load();
+		if (LastRuntime == Runtime && LastGeneration == Generation)
+		{
+			return LastTable;
+		}
+
+		FScopeLock Lock(&PropertyIdTablesLock);
+		TSharedPtr<FPropertyIdTable>& Table = PropertyIdTables.FindOrAdd(Runtime);
+		if (!Table.IsValid())
+		{
+			Table = MakeShared<FPropertyIdTable>();
+		}
+
+		LastRuntime = Runtime;
+		LastTable = Table.Get();
+		LastGeneration = Generation;
+		return LastTable;
+	}
+}
+
+UObject* FNativeHandle::GetObject() const
+{
+	if (Type != ENativeHandleType::Object)
+	{
+		return nullptr;
+	}
+
+	// the slot may have been reused by another object since
+	FUObjectItem* Item = GUObjectArray.IndexToObject(ObjectIndex);
+	if (Item && Item->Object == Ptr && Item->GetSerialNumber() == SerialNumber && !Item->IsPendingKill())
+	{
+		return reinterpret_cast<UObject*>(Ptr);
+	}
+
+	return nullptr;
+}
+
+namespace
+{
+	JsPropertyIdRef GetNativeHandleID()
+	{
+		FPropertyIdTable* Table = GetPropertyIdTable();
+		if (Table == nullptr)
+		{
+			return JS_INVALID_REFERENCE;
+		}
+
+		if (Table->NativeHandle == JS_INVALID_REFERENCE)
+		{
+			JsValueRef Symbol = JS_INVALID_REFERENCE;
+			JsCheck(JsCreateSymbol(chakra::String("native"), &Symbol));
+			JsCheck(JsGetPropertyIdFromSymbol(Symbol, &Table->NativeHandle));
+			JsCheck(JsAddRef(Table->NativeHandle, nullptr));
+		}
+
+		return Table->NativeHandle;
+	}
+
+	void CHAKRA_CALLBACK FinalizeNativeHandle(void* Data)
+	{
+		delete reinterpret_cast<FNativeHandle*>(Data);
+	}
+}
 
 namespace chakra
 {
+	JsPropertyIdRef InternPropertyID(const char* ID)
+	{
+		const int32 Length = FCStringAnsi::Strlen(ID);
+		FPropertyIdTable* Table = GetPropertyIdTable();
+		if (Table == nullptr)
+		{
+			return CreatePropertyId(ID, Length, false);
+		}
+
+		// keyed by address; the text is compared as well since non-literal buffers may be reused
+		FInternedLiteral* Found = Table->Literals.Find(ID);
+		if (Found && FCStringAnsi::Strcmp(Found->Text.GetData(), ID) == 0)
+		{
+			return Found->PropertyId;
+		}
+
+		if (Found == nullptr && Table->Literals.Num() >= FPropertyIdTable::MaxEntries)
+		{
+			return CreatePropertyId(ID, Length, false);
+		}
+
+		JsPropertyIdRef PropID = CreatePropertyId(ID, Length, true);
+		FInternedLiteral& Entry = Table->Literals.FindOrAdd(ID);
+		Entry.Text.Reset();
+		Entry.Text.Append(ID, Length + 1);
+		Entry.PropertyId = PropID;
+		return PropID;
+	}
+
+	JsPropertyIdRef InternPropertyID(const FString& ID)
+	{
+		FPropertyIdTable* Table = GetPropertyIdTable();
+		if (Table)
+		{
+			if (JsPropertyIdRef* Found = Table->Strings.Find(ID))
+			{
+				return *Found;
+			}
+		}
+
+		const bool bIntern = Table && Table->Strings.Num() < FPropertyIdTable::MaxEntries;
+		FTCHARToUTF8 propIDStr(*ID);
+		JsPropertyIdRef PropID = CreatePropertyId(propIDStr.Get(), propIDStr.Length(), bIntern);
+		if (bIntern)
+		{
+			Table->Strings.Add(ID, PropID);
+		}
+		return PropID;
+	}
+
+	JsPropertyIdRef InternPropertyID(UProperty* Property)
+	{
+		FPropertyIdTable* Table = GetPropertyIdTable();
+		if (Table == nullptr)
+		{
+			return InternPropertyID(PropertyNameToString(Property));
+		}
+
+		// properties can be freed and their memory reused by a recompiled struct
+		FInternedProperty* Found = Table->Properties.Find(Property);
+		if (Found && Found->Name == Property->GetFName() && Found->Owner == Property->GetOwnerStruct())
+		{
+			return Found->PropertyId;
+		}
+
+		const FString Name = PropertyNameToString(Property);
+		if (Table->Strings.Num() >= FPropertyIdTable::MaxEntries && !Table->Strings.Contains(Name))
+		{
+			return InternPropertyID(Name);
+		}
+
+		JsPropertyIdRef PropID = InternPropertyID(Name);
+		Table->Properties.Add(Property, { Property->GetFName(), Property->GetOwnerStruct(), PropID });
+		return PropID;
+	}
+
+	void PurgePropertyIDs(JsRuntimeHandle Runtime)
+	{
+		// no JsRelease : disposing the runtime frees them anyway
+		FScopeLock Lock(&PropertyIdTablesLock);
+		PropertyIdTables.Remove(Runtime);
+		PropertyIdTablesGeneration++;
+	}
+
+	static thread_local bool bInterruptibleThread = false;
+
+	void SetInterruptibleThread(bool bInterruptible)
+	{
+		bInterruptibleThread = bInterruptible;
+	}
+
 	void Check(JsErrorCode error)
 	{
 #if DO_CHECK
 		if (error == JsNoError)
 			return;
 
+		if (error == JsErrorInDisabledState && bInterruptibleThread)
+			return;
+
 		UE_LOG(Javascript, Verbose, TEXT("JsError %d"), (int)error);
 
 		if (error == JsErrorScriptException || error == JsErrorScriptCompile)
@@ -34,34 +275,45 @@ namespace chakra
 
 	UObject* UObjectFromChakra(JsValueRef Value)
 	{
-		uint8* Memory = RawMemoryFromChakra(Value);
-		if (Memory)
+		UE_LOG(Javascript, Verbose, TEXT("chakra::UObjectFromChakra 0x%p"), Value);
+		const FNativeHandle* Handle = NativeHandleFromChakra(Value);
+		return Handle ? Handle->GetObject() : nullptr;
+	}
+
+	void SetNativeHandle(JsValueRef Wrapper, void* Ptr, ENativeHandleType Type)
+	{
+		JsPropertyIdRef ID = GetNativeHandleID();
+		if (ID == JS_INVALID_REFERENCE)
+			return;
+
+		auto Handle = new FNativeHandle{ Ptr, Type, INDEX_NONE, 0 };
+		if (Type == ENativeHandleType::Object)
 		{
-			UE_LOG(Javascript, Verbose, TEXT("chakra::UObjectFromChakra 0x%p"), Value);
-			auto uobj = reinterpret_cast<UObject*>(Memory);
-			if (uobj->IsValidLowLevelFast() && !uobj->IsPendingKill())
-			{
-				return uobj;
-			}
-		}	
+			Handle->ObjectIndex = GUObjectArray.ObjectToIndex(reinterpret_cast<UObjectBase*>(Ptr));
+			Handle->SerialNumber = GUObjectArray.AllocateSerialNumber(Handle->ObjectIndex);
+		}
 
-		return nullptr;
+		JsValueRef External = JS_INVALID_REFERENCE;
+		JsCheck(JsCreateExternalObject(Handle, FinalizeNativeHandle, &External));
+		JsCheck(JsSetProperty(Wrapper, ID, External, true));
 	}
 
-	uint8* RawMemoryFromChakra(JsValueRef Value)
+	const FNativeHandle* NativeHandleFromChakra(JsValueRef Value)
 	{
-		UE_LOG(Javascript, Verbose, TEXT("chakra::RawMemoryFromChakra 0x%p"), Value);
+		UE_LOG(Javascript, Verbose, TEXT("chakra::NativeHandleFromChakra 0x%p"), Value);
 		if (chakra::IsEmpty(Value) || !chakra::IsObject(Value))
 			return nullptr;
 
-		JsValueRef selfExternal = chakra::GetProperty(Value, "__self");
-		if (chakra::IsEmpty(selfExternal) || chakra::IsUndefined(selfExternal))
+		JsPropertyIdRef ID = GetNativeHandleID();
+		if (ID == JS_INVALID_REFERENCE)
 			return nullptr;
 
-		void* dataPtr = nullptr;
-		JsCheck(JsGetExternalData(selfExternal, &dataPtr));
+		JsValueRef External = JS_INVALID_REFERENCE;
+		void* Data = nullptr;
+		if (JsGetProperty(Value, ID, &External) != JsNoError || JsGetExternalData(External, &Data) != JsNoError)
+			return nullptr;
 
-		return reinterpret_cast<uint8*>(dataPtr);		
+		return reinterpret_cast<const FNativeHandle*>(Data);
 	}
 
 	UClass* UClassFromChakra(JsValueRef Value)
@@ -75,9 +327,7 @@ namespace chakra
 
 		if (type == JsFunction)
 		{
-			JsPropertyIdRef staticClass = JS_INVALID_REFERENCE;
-			JsCheck(JsCreatePropertyId("StaticClass", 11, &staticClass));
-			JsCheck(JsGetProperty(Value, staticClass, &Value));
+			JsCheck(JsGetProperty(Value, InternPropertyID("StaticClass"), &Value));
 		}
 
 		bool isExternal = false;
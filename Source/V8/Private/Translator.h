@@ -23,6 +23,25 @@ struct FNoPropertyOwner : IPropertyOwner
 	}
 };
 
+enum class ENativeHandleType : uint8
+{
+	Object,
+	Struct
+};
+
+// Native side of a wrapper, owned by the external object the wrapper holds
+struct FNativeHandle
+{
+	void* Ptr;
+	ENativeHandleType Type;
+
+	// slot and serial number in GUObjectArray, for objects
+	int32 ObjectIndex;
+	int32 SerialNumber;
+
+	UObject* GetObject() const;
+};
+
 namespace chakra
 {
 	//void ReportException(Isolate* isolate, TryCatch& try_catch);
@@ -32,7 +51,22 @@ namespace chakra
 	void CallJavascriptFunction(JsContextRef context, JsValueRef This, UFunction* SignatureFunction, JsFunctionRef func, void* Parms);
 	UClass* UClassFromChakra(JsValueRef Value);
 	UObject* UObjectFromChakra(JsValueRef Value);
-	uint8* RawMemoryFromChakra(JsValueRef Value);
+
+	// Wrappers keep their native handle under a private symbol of the runtime
+	void SetNativeHandle(JsValueRef Wrapper, void* Ptr, ENativeHandleType Type);
+	const FNativeHandle* NativeHandleFromChakra(JsValueRef Value);
 	FString StringFromArgs(const JsValueRef* args, unsigned short nargs, int StartIndex = 0);
 	void Check(JsErrorCode Error);
+
+	// Worker threads, whose runtime is disabled from another thread to stop them, treat JsErrorInDisabledState
+	// as a stop request rather than an error; the worker unwinds on its own stop flag
+	void SetInterruptibleThread(bool bInterruptible);
+
+	// Runtime-wide interned property ids; the table of a runtime must be purged before it is disposed
+	JsPropertyIdRef InternPropertyID(const char* ID);
+	JsPropertyIdRef InternPropertyID(const FString& ID);
+	JsPropertyIdRef InternPropertyID(UProperty* Property);
+	void PurgePropertyIDs(JsRuntimeHandle Runtime);
 }
+
+FString PropertyNameToString(UProperty* Property);
@@ -75,6 +75,11 @@ struct TokenWriter
 		{
 			push("number");
 		}
+		else if (Property->IsA<UInt64Property>() || Property->IsA<UUInt64Property>())
+		{
+			// numbers up to 2^53, decimal strings beyond
+			push("(number|string)");
+		}
 		else if (auto floatProperthy = Cast<UFloatProperty>(Property))
 		{
 			push("number");
@@ -116,10 +121,25 @@ struct TokenWriter
 		}
 		else if (auto arrayProperty = Cast<UArrayProperty>(Property))
 		{
-			generator.Export(arrayProperty->Inner);
+			// numeric arrays are exposed as typed arrays
+			auto Inner = arrayProperty->Inner;
+			auto ByteInner = Cast<UByteProperty>(Inner);
+
+			if (Inner->IsA<UFloatProperty>()) push("Float32Array");
+			else if (Inner->IsA<UDoubleProperty>()) push("Float64Array");
+			else if (Inner->IsA<UIntProperty>()) push("Int32Array");
+			else if (Inner->IsA<UUInt32Property>()) push("Uint32Array");
+			else if (Inner->IsA<UInt16Property>()) push("Int16Array");
+			else if (Inner->IsA<UUInt16Property>()) push("Uint16Array");
+			else if (Inner->IsA<UInt8Property>()) push("Int8Array");
+			else if (ByteInner && !ByteInner->Enum) push("Uint8Array");
+			else
+			{
+				generator.Export(Inner);
 
-			push(arrayProperty->Inner);
-			push("[]");
+				push(Inner);
+				push("[]");
+			}
 		}
 		else if (auto bytePropety = Cast<UByteProperty>(Property))
 		{
@@ -525,14 +545,14 @@ struct TypingGenerator : TypingGeneratorBase
 			w.push(";\n");
 
 			TArray<UFunction*> Functions;
-			Context.BlueprintFunctionLibraryMapping.MultiFind(source, Functions);
+			Context.GetLibraryMapping().Functions.MultiFind(source, Functions);
 
 			for (auto Function : Functions)
 			{
 				write_function(Function, true);
 			}
 
-			Context.BlueprintFunctionLibraryFactoryMapping.MultiFind(source, Functions);
+			Context.GetLibraryMapping().Factories.MultiFind(source, Functions);
 			for (auto Function : Functions)
 			{
 				write_function(Function, false, true);
@@ -7,6 +7,7 @@
 #include "Helpers.h"
 #include "Translator.h"
 #include "Exception.h"
+#include "JavascriptRuntimeMemory.h"
 
 #include "JavascriptIsolate_Private.h"
 #include "JavascriptContext_Private.h"
@@ -36,6 +37,16 @@ void UJavascriptContext::GetHeapStatistics(FJavascriptHeapStatistics& Statistics
 
 		Statistics.HeapSizeLimit = limit;
 		Statistics.UsedHeapSize = usage;
+
+		// allocation callback accounting, shared by every context of the runtime
+		if (auto Memory = FJavascriptRuntimeMemory::Find(runtime))
+		{
+			Statistics.TotalHeapSize = (int32)FMath::Min<int64>(Memory->GetPeakBytes(), MAX_int32);
+			if (Memory->GetHardLimit() > 0)
+			{
+				Statistics.TotalAvailableSize = (int32)FMath::Clamp<int64>(Memory->GetHardLimit() - Memory->GetLiveBytes(), 0, MAX_int32);
+			}
+		}
 		//JavascriptIsolate->isolate_->GetHeapStatistics(&stats);
 
 		//Statistics.TotalHeapSize = stats.total_heap_size();
@@ -50,13 +61,24 @@ void UJavascriptContext::GetHeapStatistics(FJavascriptHeapStatistics& Statistics
 }
 
 UJavascriptContext::UJavascriptContext(const FObjectInitializer& ObjectInitializer)
-: Super(ObjectInitializer)
+: Super(ObjectInitializer), Runtime(nullptr)
+{
+}
+
+void UJavascriptContext::PostInitProperties()
 {
-	const bool bIsClassDefaultObject = IsTemplate(RF_ClassDefaultObject);
-	if (!bIsClassDefaultObject)
+	Super::PostInitProperties();
+
+	// RuntimeProfile has been copied from the archetype by now; templates never own a runtime
+	if (!IsTemplate())
 	{
+		const uint64 AcquireStartCycles = FPlatformTime::Cycles64();
+		Runtime = IV8::Get().AcquireRuntime(RuntimeProfile);
+		const uint64 AcquireCycles = FPlatformTime::Cycles64() - AcquireStartCycles;
+
 		Paths = IV8::Get().GetGlobalScriptSearchPaths();
-		JavascriptContext = TSharedPtr<FJavascriptContext>(FJavascriptContext::Create(reinterpret_cast<JsRuntimeHandle>(IV8::Get().GetRuntime()), Paths));
+		JavascriptContext = TSharedPtr<FJavascriptContext>(FJavascriptContext::Create(reinterpret_cast<JsRuntimeHandle>(Runtime), Paths));
+		JavascriptContext->Startup.Cycles[(int32)EJavascriptStartupPhase::AcquireRuntime] += AcquireCycles;
 
 		Expose("Context", this);
 
@@ -72,6 +94,15 @@ UJavascriptContext::UJavascriptContext(const FObjectInitializer& ObjectInitializ
 	}
 }
 
+UJavascriptContext* UJavascriptContext::CreateWithProfile(UObject* Outer, FName InRuntimeProfile)
+{
+	// the profile travels as a property of the template, so that it is set before the runtime is acquired
+	auto Template = NewObject<UJavascriptContext>(GetTransientPackage(), NAME_None, RF_ArchetypeObject | RF_Transient);
+	Template->RuntimeProfile = InRuntimeProfile;
+
+	return NewObject<UJavascriptContext>(Outer ? Outer : GetTransientPackage(), NAME_None, RF_NoFlags, Template);
+}
+
 void UJavascriptContext::SetContextId(FString Name)
 {
 	ContextId = MakeShareable(new FString(Name));
@@ -110,7 +141,23 @@ FString UJavascriptContext::ReadScriptFile(FString Filename)
 
 void UJavascriptContext::RunFile(FString Filename)
 {
-	JavascriptContext->Public_RunFile(Filename);
+	FJavascriptStartupRecord& Startup = JavascriptContext->Startup;
+	if (Startup.bComplete)
+	{
+		JavascriptContext->Public_RunFile(Filename);
+		return;
+	}
+
+	// the first file run bootstraps the context
+	{
+		FJavascriptStartupScope StartupScope(Startup, EJavascriptStartupPhase::Bootstrap);
+		JavascriptContext->Public_RunFile(Filename);
+	}
+
+	Startup.Context = GetName();
+	Startup.Profile = RuntimeProfile;
+	Startup.Script = Filename;
+	FJavascriptStartupReport::Complete(Startup);
 }
 
 FString UJavascriptContext::RunScript(FString Script, bool bOutput)
@@ -163,6 +210,19 @@ bool UJavascriptContext::WriteDTS(FString Filename, bool bIncludingTooltip)
 	return JavascriptContext->WriteDTS(Filename, bIncludingTooltip);
 }
 
+FString UJavascriptContext::GetWrapperCensus(bool bSinceSnapshot)
+{
+	return JavascriptContext.IsValid() ? JavascriptContext->GetWrapperCensus(bSinceSnapshot) : FString();
+}
+
+void UJavascriptContext::SnapshotWrappers()
+{
+	if (JavascriptContext.IsValid())
+	{
+		JavascriptContext->SnapshotWrappers();
+	}
+}
+
 bool UJavascriptContext::HasProxyFunction(UObject* Holder, UFunction* Function)
 {
 	return JavascriptContext->HasProxyFunction(Holder, Function);
@@ -190,4 +250,10 @@ void UJavascriptContext::BeginDestroy()
 	IV8::Get().GetExecStatusChangedDelegate().Remove(ExecStatusChangeHandle);
 	JavascriptContext.Reset();
 	ContextId.Reset();
+
+	if (Runtime)
+	{
+		IV8::Get().ReleaseRuntime(Runtime);
+		Runtime = nullptr;
+	}
 }
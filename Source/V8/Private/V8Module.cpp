@@ -11,29 +11,55 @@ THIRD_PARTY_INCLUDES_END
 #include "IV8.h"
 #include "JavascriptStats.h"
 #include "JavascriptSettings.h"
+#include "Translator.h"
+#include "StructMemoryPool.h"
+#include "JavascriptRuntimeMemory.h"
+#include "JavascriptContextPool.h"
+#include "JavascriptRuntimeBindings.h"
 #include "Containers/Ticker.h"
+#include "Misc/CoreDelegates.h"
 #include "Misc/Paths.h"
 #include "UObject/UObjectIterator.h"
 
 DEFINE_STAT(STAT_V8IdleTask);
 DEFINE_STAT(STAT_JavascriptDelegate);
 DEFINE_STAT(STAT_JavascriptProxy);
-DEFINE_STAT(STAT_Scavenge);
-DEFINE_STAT(STAT_MarkSweepCompact);
-DEFINE_STAT(STAT_IncrementalMarking);
-DEFINE_STAT(STAT_ProcessWeakCallbacks);
 
 DEFINE_STAT(STAT_JavascriptPropertyGet);
 DEFINE_STAT(STAT_JavascriptPropertySet);
 DEFINE_STAT(STAT_JavascriptFunctionCallToEngine);
 DEFINE_STAT(STAT_JavascriptFunctionCallToJavascript);
 DEFINE_STAT(STAT_JavascriptReadOffStruct);
-
-DEFINE_STAT(STAT_NewSpace);
-DEFINE_STAT(STAT_OldSpace);
-DEFINE_STAT(STAT_CodeSpace);
-DEFINE_STAT(STAT_MapSpace);
-DEFINE_STAT(STAT_LoSpace);
+DEFINE_STAT(STAT_JavascriptTasks);
+DEFINE_STAT(STAT_JavascriptTimerCallback);
+DEFINE_STAT(STAT_JavascriptGC);
+
+DEFINE_STAT(STAT_JavascriptModuleCacheHit);
+DEFINE_STAT(STAT_JavascriptModuleCacheMiss);
+DEFINE_STAT(STAT_JavascriptTasksRun);
+DEFINE_STAT(STAT_JavascriptTaskQueueDepth);
+DEFINE_STAT(STAT_JavascriptTaskOverrun);
+DEFINE_STAT(STAT_JavascriptStructInstances);
+DEFINE_STAT(STAT_JavascriptTimers);
+DEFINE_STAT(STAT_JavascriptGCCount);
+DEFINE_STAT(STAT_JavascriptGCOverBudget);
+DEFINE_STAT(STAT_JavascriptPooledContexts);
+DEFINE_STAT(STAT_JavascriptGCPause);
+DEFINE_STAT(STAT_JavascriptAllocationRate);
+
+DEFINE_STAT(STAT_JavascriptStartupTotal);
+DEFINE_STAT(STAT_JavascriptStartupAcquireRuntime);
+DEFINE_STAT(STAT_JavascriptStartupCreateContext);
+DEFINE_STAT(STAT_JavascriptStartupGlobalTemplate);
+DEFINE_STAT(STAT_JavascriptStartupCopyGlobalTemplate);
+DEFINE_STAT(STAT_JavascriptStartupExposeGlobals);
+DEFINE_STAT(STAT_JavascriptStartupLibraryMapping);
+DEFINE_STAT(STAT_JavascriptStartupTypeExport);
+DEFINE_STAT(STAT_JavascriptStartupBootstrap);
+
+DEFINE_STAT(STAT_JavascriptHeapLive);
+DEFINE_STAT(STAT_JavascriptHeapPeak);
+DEFINE_STAT(STAT_JavascriptStructPool);
 
 static float GV8IdleTaskBudget = 1 / 60.0f;
 
@@ -49,12 +75,62 @@ void UJavascriptSettings::Apply() const
 	//IV8::Get().SetFlagsFromString(V8Flags);
 }
 
+const FJavascriptRuntimeProfile& UJavascriptSettings::FindRuntimeProfile(FName Name) const
+{
+	if (!Name.IsNone())
+	{
+		for (const auto& Profile : RuntimeProfiles)
+		{
+			if (Profile.Name == Name)
+			{
+				return Profile;
+			}
+		}
+
+		UE_LOG(Javascript, Warning, TEXT("Unknown runtime profile '%s', using default"), *Name.ToString());
+	}
+
+	return DefaultRuntimeProfile;
+}
+
+FJavascriptRuntimeProfile::FJavascriptRuntimeProfile()
+	: bEnableJIT(false)
+	, bEnableBackgroundWork(true)
+	, MemoryLimitMB(0)
+	, SoftMemoryLimitMB(0)
+	, bIsolatedRuntime(false)
+	, PooledContexts(0)
+{
+}
+
+uint32 FJavascriptRuntimeProfile::GetRuntimeAttributes() const
+{
+	// contexts call JsIdle from their ticker
+	uint32 Attributes = JsRuntimeAttributeEnableIdleProcessing;
+
+	if (!bEnableJIT)
+	{
+		Attributes |= JsRuntimeAttributeDisableNativeCodeGeneration;
+	}
+
+	if (!bEnableBackgroundWork)
+	{
+		Attributes |= JsRuntimeAttributeDisableBackgroundWork;
+	}
+
+	return Attributes;
+}
+
 class V8Module : public IV8
 {
 public:
 	TArray<FString> Paths;
 	JsRuntimeHandle ChakraRuntime = JS_INVALID_RUNTIME_HANDLE;
+	TMap<FName, JsRuntimeHandle> SharedRuntimes; // shared runtimes of named profiles
+	TSet<JsRuntimeHandle> IsolatedRuntimes;
 	FJavascriptExecStateChangedDelegate OnExecStateChangedDelegate;
+	TUniquePtr<FJavascriptContextPool> ContextPool;
+	FDelegateHandle EndFrameHandle;
 
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override
@@ -70,9 +146,18 @@ public:
 		const UJavascriptSettings& Settings = *GetDefault<UJavascriptSettings>();
 		Settings.Apply();
 
+		FJavascriptRuntimeBindings::Startup();
+
 		//V8::InitializeICUDefaultLocation(nullptr);
-		JsErrorCode createErr = JsCreateRuntime(JsRuntimeAttributeDisableNativeCodeGeneration, nullptr, &ChakraRuntime);
-		checkf(createErr == JsNoError, TEXT("Failed to create javascript runtime! %d"), (int)createErr);
+		ChakraRuntime = CreateRuntime(Settings.DefaultRuntimeProfile);
+		checkf(ChakraRuntime != JS_INVALID_RUNTIME_HANDLE, TEXT("Failed to create javascript runtime!"));
+
+		ContextPool = MakeUnique<FJavascriptContextPool>();
+
+		// after every ticker has run, so collections go into what scripts left of the frame
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddLambda([]() {
+			FJavascriptRuntimeMemory::TickRuntimes(GV8IdleTaskBudget);
+		});
 
 		FName NAME_JavascriptCmd("JavascriptCmd");
 		GLog->Log(NAME_JavascriptCmd, ELogVerbosity::Log, *FString::Printf(TEXT("Unreal.js started. ChakraCore %d.%d.%d"), CHAKRA_CORE_MAJOR_VERSION, CHAKRA_CORE_MINOR_VERSION, CHAKRA_CORE_PATCH_VERSION));
@@ -80,7 +165,62 @@ public:
 
 	virtual void ShutdownModule() override
 	{		
-		JsDisposeRuntime(ChakraRuntime);
+		ContextPool.Reset();
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+		for (auto Runtime : IsolatedRuntimes)
+		{
+			DisposeRuntime(Runtime);
+		}
+		IsolatedRuntimes.Empty();
+
+		for (auto& Pair : SharedRuntimes)
+		{
+			DisposeRuntime(Pair.Value);
+		}
+		SharedRuntimes.Empty();
+
+		DisposeRuntime(ChakraRuntime);
+		ChakraRuntime = JS_INVALID_RUNTIME_HANDLE;
+
+		FJavascriptRuntimeBindings::Shutdown();
+
+		FStructMemoryPool::Shutdown();
+	}
+
+	static JsRuntimeHandle CreateRuntime(const FJavascriptRuntimeProfile& Profile)
+	{
+		JsRuntimeHandle Runtime = JS_INVALID_RUNTIME_HANDLE;
+		JsErrorCode createErr = JsCreateRuntime((JsRuntimeAttributes)Profile.GetRuntimeAttributes(), nullptr, &Runtime);
+		if (createErr != JsNoError)
+		{
+			UE_LOG(Javascript, Error, TEXT("Failed to create javascript runtime! %d"), (int)createErr);
+			return JS_INVALID_RUNTIME_HANDLE;
+		}
+
+		if (Profile.MemoryLimitMB > 0)
+		{
+			JsSetRuntimeMemoryLimit(Runtime, (size_t)Profile.MemoryLimitMB * 1024 * 1024);
+		}
+
+		FJavascriptRuntimeMemory::Attach(Runtime, Profile);
+		FJavascriptRuntimeBindings::Attach(Runtime);
+
+		UE_LOG(Javascript, Log, TEXT("Runtime created (profile: %s, JIT: %d, background work: %d, memory limit: %dMB)"),
+			Profile.Name.IsNone() ? TEXT("default") : *Profile.Name.ToString(), Profile.bEnableJIT, Profile.bEnableBackgroundWork, Profile.MemoryLimitMB);
+
+		return Runtime;
+	}
+
+	static void DisposeRuntime(JsRuntimeHandle Runtime)
+	{
+		if (Runtime != JS_INVALID_RUNTIME_HANDLE)
+		{
+			chakra::PurgePropertyIDs(Runtime);
+			JsDisposeRuntime(Runtime);
+			FJavascriptRuntimeMemory::Detach(Runtime);
+			FJavascriptRuntimeBindings::Detach(Runtime);
+		}
 	}
 
 	//@HACK
@@ -230,11 +370,65 @@ public:
 		GV8IdleTaskBudget = BudgetInSeconds;
 	}
 
+	virtual float GetIdleTaskBudget() const override
+	{
+		return GV8IdleTaskBudget;
+	}
+
 	virtual void* GetRuntime() override
 	{
 		return ChakraRuntime;
 	}
 
+	virtual void* AcquireRuntime(FName Profile) override
+	{
+		const FJavascriptRuntimeProfile& RuntimeProfile = GetDefault<UJavascriptSettings>()->FindRuntimeProfile(Profile);
+
+		if (RuntimeProfile.bIsolatedRuntime)
+		{
+			JsRuntimeHandle Runtime = CreateRuntime(RuntimeProfile);
+			if (Runtime != JS_INVALID_RUNTIME_HANDLE)
+			{
+				IsolatedRuntimes.Add(Runtime);
+				return Runtime;
+			}
+		}
+		else if (!RuntimeProfile.Name.IsNone())
+		{
+			JsRuntimeHandle& Runtime = SharedRuntimes.FindOrAdd(RuntimeProfile.Name);
+			if (Runtime == JS_INVALID_RUNTIME_HANDLE)
+			{
+				Runtime = CreateRuntime(RuntimeProfile);
+			}
+
+			if (Runtime != JS_INVALID_RUNTIME_HANDLE)
+			{
+				return Runtime;
+			}
+		}
+
+		return ChakraRuntime;
+	}
+
+	virtual void ReleaseRuntime(void* Runtime) override
+	{
+		// shared runtimes live until shutdown
+		if (IsolatedRuntimes.Remove(Runtime) > 0)
+		{
+			DisposeRuntime(Runtime);
+		}
+	}
+
+	virtual UJavascriptContext* AcquireContext(FName Profile) override
+	{
+		return ContextPool->Acquire(Profile);
+	}
+
+	virtual void PrewarmContexts() override
+	{
+		ContextPool->Prewarm();
+	}
+
 	//virtual void* GetV8Platform() override
 	//{
 	//	return platform_.platform();
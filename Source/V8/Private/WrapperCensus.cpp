@@ -0,0 +1,197 @@
+#include "WrapperCensus.h"
+#include "JavascriptContext.h"
+#include "JavascriptContext_Private.h"
+#include "Translator.h"
+#include "Helpers.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+PRAGMA_DISABLE_SHADOW_VARIABLE_WARNINGS
+
+static TAutoConsoleVariable<int32> CVarWrapperCensusSampleRate(
+	TEXT("javascript.WrapperCensus.SampleRate"),
+	0,
+	TEXT("Record the script stack of every Nth wrapper created for a UObject or struct instance (0 = off)"));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice WrapperCensusCommand(
+	TEXT("javascript.WrapperCensus"),
+	TEXT("Lists live script wrappers of UObjects and struct instances per type and context. 'snapshot' remembers the current census, 'diff' lists the changes since"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar) {
+		const bool bSnapshot = Args.Contains(TEXT("snapshot"));
+		const bool bDiff = Args.Contains(TEXT("diff"));
+
+		for (TObjectIterator<UJavascriptContext> It; It; ++It)
+		{
+			if (!It->JavascriptContext.IsValid())
+			{
+				continue;
+			}
+
+			if (bSnapshot)
+			{
+				It->SnapshotWrappers();
+				Ar.Logf(TEXT("%s: snapshot taken"), *It->GetName());
+			}
+			else
+			{
+				Ar.Logf(TEXT("%s:"), *It->GetName());
+				Ar.Log(It->GetWrapperCensus(bDiff));
+			}
+		}
+	}));
+
+namespace
+{
+	// how many sampled stacks are listed per type
+	const int32 MaxStacksPerType = 3;
+
+	FString CaptureStack()
+	{
+		JsValueRef global = JS_INVALID_REFERENCE;
+		JsCheck(JsGetGlobalObject(&global));
+
+		JsValueRef ErrorFunction = chakra::GetProperty(global, "Error");
+		if (!chakra::IsFunction(ErrorFunction))
+		{
+			return FString();
+		}
+
+		JsValueRef Error = chakra::New(ErrorFunction);
+		FString Stack = chakra::StringFromChakra(chakra::GetProperty(Error, "stack"));
+
+		// drop the "Error" line
+		int32 LineEnd = INDEX_NONE;
+		if (Stack.FindChar(TEXT('\n'), LineEnd))
+		{
+			Stack.RemoveAt(0, LineEnd + 1);
+		}
+		return Stack.TrimStartAndEnd();
+	}
+}
+
+void FJavascriptWrapperCensus::OnCreated(const void* Key)
+{
+	const int32 SampleRate = CVarWrapperCensusSampleRate.GetValueOnGameThread();
+	if (SampleRate <= 0)
+	{
+		return;
+	}
+
+	if (--Countdown > 0)
+	{
+		return;
+	}
+	Countdown = SampleRate;
+
+	FString Stack = CaptureStack();
+	if (!Stack.IsEmpty())
+	{
+		SampledStacks.Add(Key, MoveTemp(Stack));
+	}
+}
+
+void FJavascriptWrapperCensus::OnReleased(const void* Key)
+{
+	if (SampledStacks.Num())
+	{
+		SampledStacks.Remove(Key);
+	}
+}
+
+void FJavascriptWrapperCensus::Reset()
+{
+	SampledStacks.Empty();
+}
+
+void FJavascriptWrapperCensus::Add(FReport& Report, const FString& Type, bool bStruct, int64 Bytes, const void* Key) const
+{
+	FEntry& Entry = Report.FindOrAdd(Type);
+	Entry.bStruct = bStruct;
+	Entry.Count++;
+	Entry.Bytes += Bytes;
+
+	if (const FString* Stack = SampledStacks.Find(Key))
+	{
+		Entry.Stacks.FindOrAdd(*Stack)++;
+	}
+}
+
+void FJavascriptWrapperCensus::Snapshot(const FReport& Report)
+{
+	SnapshotEntries = Report;
+	bHasSnapshot = true;
+}
+
+void FJavascriptWrapperCensus::Dump(FOutputDevice& Ar, FReport& Report, bool bSinceSnapshot) const
+{
+	if (bSinceSnapshot && !bHasSnapshot)
+	{
+		Ar.Log(TEXT("No snapshot taken yet, use javascript.WrapperCensus snapshot"));
+		return;
+	}
+
+	// types which went away entirely since the snapshot show up with negative counts
+	if (bSinceSnapshot)
+	{
+		for (const auto& Pair : SnapshotEntries)
+		{
+			if (!Report.Contains(Pair.Key))
+			{
+				FEntry& Entry = Report.Add(Pair.Key);
+				Entry.bStruct = Pair.Value.bStruct;
+			}
+		}
+	}
+
+	Report.ValueSort([](const FEntry& A, const FEntry& B) { return A.Bytes > B.Bytes; });
+
+	int32 TotalCount = 0;
+	int64 TotalBytes = 0;
+
+	Ar.Logf(TEXT("%-48s %-6s %10s %12s"), TEXT("Type"), TEXT("Kind"), bSinceSnapshot ? TEXT("+Count") : TEXT("Count"), bSinceSnapshot ? TEXT("+Bytes") : TEXT("Bytes"));
+	for (const auto& Pair : Report)
+	{
+		const FEntry& Entry = Pair.Value;
+		int32 Count = Entry.Count;
+		int64 Bytes = Entry.Bytes;
+
+		if (bSinceSnapshot)
+		{
+			if (const FEntry* Previous = SnapshotEntries.Find(Pair.Key))
+			{
+				Count -= Previous->Count;
+				Bytes -= Previous->Bytes;
+			}
+
+			if (Count == 0 && Bytes == 0)
+			{
+				continue;
+			}
+		}
+
+		TotalCount += Count;
+		TotalBytes += Bytes;
+		Ar.Logf(TEXT("%-48s %-6s %10d %12lld"), *Pair.Key, Entry.bStruct ? TEXT("struct") : TEXT("object"), Count, Bytes);
+
+		TArray<TPair<FString, int32>> Stacks;
+		for (const auto& Stack : Entry.Stacks)
+		{
+			Stacks.Emplace(Stack.Key, Stack.Value);
+		}
+		Stacks.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B) { return A.Value > B.Value; });
+
+		for (int32 Index = 0; Index < FMath::Min(Stacks.Num(), MaxStacksPerType); ++Index)
+		{
+			Ar.Logf(TEXT("    %d sampled from:"), Stacks[Index].Value);
+			TArray<FString> Lines;
+			Stacks[Index].Key.ParseIntoArrayLines(Lines);
+			for (const FString& Line : Lines)
+			{
+				Ar.Logf(TEXT("        %s"), *Line.TrimStart());
+			}
+		}
+	}
+	Ar.Logf(TEXT("%-48s %-6s %10d %12lld"), TEXT("Total"), TEXT(""), TotalCount, TotalBytes);
+}
+
+PRAGMA_ENABLE_SHADOW_VARIABLE_WARNINGS
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "V8PCH.h"
+
+// Census of the wrappers a context keeps alive for UObjects and struct instances.
+// Creation stacks are sampled (every Nth wrapper, javascript.WrapperCensus.SampleRate) so that
+// leaking call sites can be found, and a snapshot allows diffing the census between two points in time.
+class FJavascriptWrapperCensus
+{
+public:
+	struct FEntry
+	{
+		bool bStruct = false;
+		int32 Count = 0;
+		int64 Bytes = 0;
+		// sampled creation stacks and how many live wrappers came from each
+		TMap<FString, int32> Stacks;
+	};
+
+	// keyed by type name
+	typedef TMap<FString, FEntry> FReport;
+
+	// Must be called with the context current, Key identifies the wrapped object or instance
+	void OnCreated(const void* Key);
+	void OnReleased(const void* Key);
+	void Reset();
+
+	// Counts one live wrapper into Report
+	void Add(FReport& Report, const FString& Type, bool bStruct, int64 Bytes, const void* Key) const;
+
+	void Snapshot(const FReport& Report);
+	void Dump(FOutputDevice& Ar, FReport& Report, bool bSinceSnapshot) const;
+
+private:
+	TMap<const void*, FString> SampledStacks;
+	TMap<FString, FEntry> SnapshotEntries;
+	bool bHasSnapshot = false;
+	int32 Countdown = 0;
+};
@@ -5,6 +5,8 @@
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FJavascriptExecStateChangedDelegate, bool);
 
+class UJavascriptContext;
+
 /**
 * The public interface to this module. 
 */
@@ -35,6 +37,19 @@ public:
 	//virtual void SetFlagsFromString(const FString& Flags) = 0;
 	virtual void SetIdleTaskBudget(float BudgetInSeconds) = 0;
 
+	// Time each context may spend on pending script tasks per tick
+	virtual float GetIdleTaskBudget() const = 0;
+
 	virtual void* GetRuntime() = 0;
+
+	// Runtime for a context using the named profile of UJavascriptSettings; isolated profiles get a new runtime each time
+	virtual void* AcquireRuntime(FName Profile) = 0;
+	virtual void ReleaseRuntime(void* Runtime) = 0;
+
+	// Context of the named profile, taken from its pool when the profile keeps one
+	virtual UJavascriptContext* AcquireContext(FName Profile) = 0;
+
+	// Fills the context pools of all profiles, e.g. while a loading screen is up
+	virtual void PrewarmContexts() = 0;
 	//virtual void* GetV8Platform() = 0;
 };
@@ -49,6 +49,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Javascript")
 	bool bActiveWithinEditor;
 
+	// Runtime profile from the Javascript project settings, none for the default runtime
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Javascript")
+	FName RuntimeProfile;
+
 	UPROPERTY(transient)
 	UJavascriptContext* JavascriptContext;	
 
@@ -90,6 +94,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Javascript")
 	void Invoke(FName Name);
 
+	/** Pauses every context while Work runs; use a script Worker for work in parallel with gameplay scripts */
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
 	void DoInBackground(FJavascriptFunction Work, FJavascriptFunction Callback);
 
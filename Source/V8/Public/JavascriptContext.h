@@ -127,6 +127,7 @@ class V8_API UJavascriptContext : public UObject
 
 public:
 	// Begin UObject interface.
+	virtual void PostInitProperties() override;
 	virtual void BeginDestroy() override;
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 	// End UObject interface.
@@ -139,6 +140,15 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = "Scripting|Javascript")
 	TArray<FString> Paths;
 
+	// Runtime profile of UJavascriptSettings this context was created with, copied from the template passed to NewObject
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	FName RuntimeProfile;
+
+	void* Runtime;
+
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	static UJavascriptContext* CreateWithProfile(UObject* Outer, FName InRuntimeProfile);
+
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
 	void SetContextId(FString Name);
 
@@ -187,6 +197,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
 	void GetHeapStatistics(FJavascriptHeapStatistics& Statistics);
 
+	// Live wrappers of UObjects and struct instances per type, or their changes since SnapshotWrappers
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	FString GetWrapperCensus(bool bSinceSnapshot = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	void SnapshotWrappers();
+
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
 	void PauseTick();
 
@@ -10,7 +10,6 @@ class V8_API UJavascriptDelegate : public UObject
 	GENERATED_BODY()
 
 public:
-	int32 UniqueId;
 	bool Paused;
 	FDelegateHandle PausedHandle;
 
@@ -412,7 +412,6 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Scripting | Javascript")
 	static TArray<ULevel*> GetLevels(UWorld* World);
 
-#if 0
 	UFUNCTION(BlueprintCallable, Category = "Scripting | Javascript")
 	static FString GetFunctionName(FJavascriptProfileNode Node);
 
@@ -459,7 +458,6 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Scripting | Javascript")
 	static FString GetDeoptInfo_Stack(FJavascriptProfileNode Node, int32 index);
-#endif
 
 	UFUNCTION(BlueprintCallable, Category = "Scripting | Javascript")
 	static FString GetArchetypePathName(UObject* Object);
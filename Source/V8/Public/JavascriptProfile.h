@@ -1,16 +1,17 @@
 #pragma once
 
-// chakra core does not support cpu profiling
-#if 0
-
 #include "JavascriptProfile.generated.h"
 
+struct FJavascriptProfileData;
+
 USTRUCT(BlueprintType)
 struct FJavascriptProfileNode
 {
 	GENERATED_BODY()
 
-	const void* Node;
+	// shared with the profile it came from, nodes stay valid after the UJavascriptProfile is collected
+	TSharedPtr<const FJavascriptProfileData> Profile;
+	int32 Index{ INDEX_NONE };
 };
 
 UCLASS(BlueprintType)
@@ -19,7 +20,7 @@ class V8_API UJavascriptProfile : public UObject
 	GENERATED_BODY()
 
 public:
-	void* Profile{ nullptr };
+	TSharedPtr<FJavascriptProfileData> Profile;
 
 	virtual void BeginDestroy() override;
 
@@ -35,6 +36,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Javascript | Scripting")
 	float GetSampleTimestamp(int32 index);
 
+	// Writes the profile as .cpuprofile, which Chrome DevTools can load
+	UFUNCTION(BlueprintCallable, Category = "Javascript | Scripting")
+	bool Save(const FString& Filename);
+
+	// Samples the runtime of the calling script, or the default runtime. Samples are always recorded.
 	UFUNCTION(BlueprintCallable, Category = "Javascript | Scripting")
 	static void Start(const FString& Title, bool bRecordSamples);
 
@@ -47,5 +53,3 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Javascript | Scripting")
 	static void SetIdle(bool is_idle);
 };
-
-#endif
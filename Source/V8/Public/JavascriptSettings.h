@@ -2,6 +2,52 @@
 
 #include "JavascriptSettings.generated.h"
 
+USTRUCT()
+struct V8_API FJavascriptRuntimeProfile
+{
+	GENERATED_BODY()
+
+	FJavascriptRuntimeProfile();
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ToolTip = "Name to select this profile with; the default profile is used for unknown names"))
+	FName Name;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		DisplayName = "Enable JIT",
+		ToolTip = "Generate native code for hot functions. Leave off on platforms which don't allow executable memory"))
+	bool bEnableJIT;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ToolTip = "Run JIT compilation and concurrent GC on background threads"))
+	bool bEnableBackgroundWork;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ClampMin = "0", DisplayName = "Memory Limit (MB)",
+		ToolTip = "Heap limit of the runtime in megabytes, 0 for no limit"))
+	int32 MemoryLimitMB;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ClampMin = "0", DisplayName = "Soft Memory Limit (MB)",
+		ToolTip = "Heap usage in megabytes at which scripts get an onmemorypressure call, 0 for 90% of the memory limit"))
+	int32 SoftMemoryLimitMB;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ToolTip = "Give each context a runtime of its own instead of sharing one runtime per profile"))
+	bool bIsolatedRuntime;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ClampMin = "0",
+		ToolTip = "Contexts of this profile created ahead of time, on map loads and PrewarmContexts (javascript.ContextPool.Refill also refills during play, one context startup per frame)"))
+	int32 PooledContexts;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ToolTip = "Script run on pooled contexts before they're handed out, e.g. modules shared by all components"))
+	FString PooledBootstrapScript;
+
+	/** JsRuntimeAttributes for this profile */
+	uint32 GetRuntimeAttributes() const;
+};
 
 UCLASS(config = Engine, defaultconfig)
 class V8_API UJavascriptSettings
@@ -15,5 +61,15 @@ public:
 		ToolTip = "V8 Flags. Please refer to V8 documentation"))
 	FString V8Flags;	
 
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ToolTip = "Runtime profile of contexts which don't ask for a specific one"))
+	FJavascriptRuntimeProfile DefaultRuntimeProfile;
+
+	UPROPERTY(EditAnywhere, config, Category = Javascript, meta = (
+		ToolTip = "Additional runtime profiles, selected by name per context"))
+	TArray<FJavascriptRuntimeProfile> RuntimeProfiles;
+
 	void Apply() const;
+
+	const FJavascriptRuntimeProfile& FindRuntimeProfile(FName Name) const;
 };